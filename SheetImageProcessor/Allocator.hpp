@@ -0,0 +1,95 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Sheet Image Processor (https://github.com/Hapaxia/SheetImageProcessor
+// --
+//
+// Allocator
+//
+// Copyright(c) 2025-2026 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions :
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software.If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Common.hpp"
+
+#include <new>
+
+namespace sheetimageprocessor
+{
+
+// allocates memory aligned to Alignment bytes. elements are default-initialised (not zeroed) when a vector grows
+template <class T, std::size_t Alignment = 64u>
+class AlignedAllocator
+{
+public:
+	using value_type = T;
+
+	template <class U>
+	struct rebind
+	{
+		using other = AlignedAllocator<U, Alignment>;
+	};
+
+	constexpr AlignedAllocator() noexcept = default;
+	template <class U>
+	constexpr AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept
+	{
+	}
+
+	T* allocate(const std::size_t n)
+	{
+		return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{ Alignment }));
+	}
+	void deallocate(T* const p, const std::size_t) noexcept
+	{
+		::operator delete(p, std::align_val_t{ Alignment });
+	}
+
+	template <class U>
+	void construct(U* const p) noexcept
+	{
+		::new (static_cast<void*>(p)) U;
+	}
+	template <class U, class... Args>
+	void construct(U* const p, Args&&... args)
+	{
+		::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+	}
+
+	template <class U>
+	constexpr bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept
+	{
+		return true;
+	}
+	template <class U>
+	constexpr bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept
+	{
+		return false;
+	}
+};
+
+using AlignedBuffer = std::vector<std::uint8_t, AlignedAllocator<std::uint8_t>>;
+
+} // namespace sheetimageprocessor
@@ -103,7 +103,12 @@ public:
 		Xy targetRectSize,
 		std::size_t separation = 0u,
 		std::size_t expansion = 0u,
-		bool sortByArea = false);
+		bool sortByArea = false,
+		std::size_t alignment = 1u, // each tile's footprint (the tile with its expansion and separation) starts at a multiple of this and its size is rounded up to a multiple of it. e.g. 4 keeps each tile in its own compressed blocks
+		bool isPowerOfTwoCell = false); // each tile's footprint is rounded up to a power of two in each dimension (before alignment)
+
+	std::vector<std::size_t> getBlitOrder(std::size_t cellSize = 64u) const; // returns tile indices ordered along a Hilbert curve over the tiles' positions (in cells of cellSize) so that tiles near each other in the image are processed together
+	std::vector<std::size_t> getBlitOrder(const Atlas& sourceAtlas, std::size_t cellSize = 64u) const; // as above but tiles in the same cell are also grouped by their source rows (the tile with the same index in sourceAtlas)
 
 	std::vector<Tile> get() const;
 	std::vector<Tile> getAllCategory(std::size_t category) const;
@@ -117,6 +122,7 @@ private:
 	bool priv_isUnlimitedMaxSize() const;
 	bool priv_isWithinMaxSize(const Xy position) const;
 	bool priv_isWithinMaxSize(const Rect rect) const;
+	std::vector<std::size_t> priv_getBlitOrder(const Atlas* sourceAtlas, std::size_t cellSize) const;
 };
 
 } // namespace sheetimageprocessor
@@ -34,6 +34,7 @@
 #include "Atlas.hpp"
 
 #include <algorithm>
+#include <cmath>
 
 #include <iostream>
 
@@ -305,8 +306,13 @@ inline std::vector<std::size_t> Atlas::pack(
 	const Xy targetRectSize,
 	const std::size_t separation,
 	const std::size_t expansion,
-	const bool sortByArea)
+	const bool sortByArea,
+	std::size_t alignment,
+	const bool isPowerOfTwoCell)
 {
+	if (alignment == 0u)
+		alignment = 1u;
+
 	std::vector<std::size_t> unusedIndices{};
 
 	const std::size_t numOfTiles{ getSize() };
@@ -326,6 +332,12 @@ inline std::vector<std::size_t> Atlas::pack(
 		Rect rect{};
 		int imageIndex{ -1 };
 
+		~Node()
+		{
+			delete children[0u];
+			delete children[1u];
+		}
+
 		Node* insert(const Atlas::Tile& tile)
 		{
 			if ((children[0u] != nullptr) || (children[1u] != nullptr))
@@ -394,6 +406,19 @@ inline std::vector<std::size_t> Atlas::pack(
 	Xy expansionVector{ expansion + expansion, expansion + expansion };
 	Xy extraVector{ separationVector + expansionVector };
 
+	// positions are the sums of footprints so aligned footprints also give aligned positions
+	auto getFootprint = [&](const std::size_t size)
+	{
+		std::size_t footprint{ size };
+		if (isPowerOfTwoCell)
+		{
+			footprint = 1u;
+			while (footprint < size)
+				footprint *= 2u;
+		}
+		return ((footprint + alignment - 1u) / alignment) * alignment;
+	};
+
 	Node* root = new Node{};
 	root->rect = { { 0u, 0u }, targetRectSize + separationVector }; // adding the separation vector here allows the bottom and right edges to ignore the separation
 
@@ -401,6 +426,7 @@ inline std::vector<std::size_t> Atlas::pack(
 	{
 		Atlas::Tile tile{ get(orderedIndices[i]) };
 		tile.rect.size += extraVector;
+		tile.rect.size = { getFootprint(tile.rect.size.x), getFootprint(tile.rect.size.y) };
 
 		Node* node = root->insert(tile);
 		if (node != nullptr)
@@ -421,9 +447,21 @@ inline std::vector<std::size_t> Atlas::pack(
 		m_tiles[orderedIndex].rect.position = node->rect.position + Xy{ expansion, expansion };
 	}
 
+	delete root;
+
 	return unusedIndices;
 }
 
+inline std::vector<std::size_t> Atlas::getBlitOrder(const std::size_t cellSize) const
+{
+	return priv_getBlitOrder(nullptr, cellSize);
+}
+
+inline std::vector<std::size_t> Atlas::getBlitOrder(const Atlas& sourceAtlas, const std::size_t cellSize) const
+{
+	return priv_getBlitOrder(&sourceAtlas, cellSize);
+}
+
 inline std::vector<Atlas::Tile> Atlas::get() const
 {
 	return m_tiles;
@@ -482,4 +520,66 @@ inline bool Atlas::priv_isWithinMaxSize(const Rect rect) const
 	return (priv_isUnlimitedMaxSize() || (((rect.position.x + rect.size.x) <= m_maxSize.x) && ((rect.position.y + rect.size.y) <= m_maxSize.y)));
 }
 
+inline std::vector<std::size_t> Atlas::priv_getBlitOrder(const Atlas* sourceAtlas, std::size_t cellSize) const
+{
+	if (cellSize == 0u)
+		cellSize = 1u;
+	const std::size_t numOfTiles{ getSize() };
+	const bool isGroupedBySource{ (sourceAtlas != nullptr) && (sourceAtlas->getSize() == numOfTiles) };
+
+	// the Hilbert curve covers a square grid of cells with a power-of-two side
+	const Xy numberOfCells{ (getMaxUsed() / cellSize) + Xy{ 1u, 1u } };
+	std::size_t curveSize{ 1u };
+	while ((curveSize < numberOfCells.x) || (curveSize < numberOfCells.y))
+		curveSize *= 2u;
+
+	auto getHilbertIndex = [curveSize](Xy cell)
+	{
+		std::size_t index{ 0u };
+		for (std::size_t s{ curveSize / 2u }; s > 0u; s /= 2u)
+		{
+			const std::size_t rx{ ((cell.x & s) > 0u) ? 1u : 0u };
+			const std::size_t ry{ ((cell.y & s) > 0u) ? 1u : 0u };
+			index += s * s * ((3u * rx) ^ ry);
+			if (ry == 0u)
+			{
+				if (rx == 1u)
+				{
+					cell.x = s - 1u - cell.x;
+					cell.y = s - 1u - cell.y;
+				}
+				std::swap(cell.x, cell.y);
+			}
+		}
+		return index;
+	};
+
+	struct BlitKey
+	{
+		std::size_t curveIndex;
+		std::size_t sourceRow;
+		std::size_t tileIndex;
+	};
+	std::vector<BlitKey> keys(numOfTiles);
+	for (std::size_t i{ 0u }; i < numOfTiles; ++i)
+	{
+		const Xy cell{ m_tiles[i].rect.position / cellSize };
+		const std::size_t sourceRow{ isGroupedBySource ? sourceAtlas->m_tiles[i].rect.position.y : 0u };
+		keys[i] = { getHilbertIndex({ cell.x & (curveSize - 1u), cell.y & (curveSize - 1u) }), sourceRow, i };
+	}
+	std::sort(keys.begin(), keys.end(), [](const BlitKey& lhs, const BlitKey& rhs)
+	{
+		if (lhs.curveIndex != rhs.curveIndex)
+			return (lhs.curveIndex < rhs.curveIndex);
+		if (lhs.sourceRow != rhs.sourceRow)
+			return (lhs.sourceRow < rhs.sourceRow);
+		return (lhs.tileIndex < rhs.tileIndex);
+	});
+
+	std::vector<std::size_t> order(numOfTiles);
+	for (std::size_t i{ 0u }; i < numOfTiles; ++i)
+		order[i] = keys[i].tileIndex;
+	return order;
+}
+
 } // namespace sheetimageprocessor
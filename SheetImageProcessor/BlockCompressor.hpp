@@ -0,0 +1,86 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Sheet Image Processor (https://github.com/Hapaxia/SheetImageProcessor
+// --
+//
+// BlockCompressor
+//
+// Copyright(c) 2025-2026 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions :
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software.If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Common.hpp"
+#include "Image.hpp"
+#include "Atlas.hpp"
+
+namespace sheetimageprocessor
+{
+
+// compresses an image into GPU blocks of 4x4 pixels, ready for upload. blocks are in the image's stored row order; edge blocks repeat the image's edge pixels.
+// with an atlas, blocks with no tile pixels are treated as padding and are written as a single colour (their mean) without searching for endpoints
+class BlockCompressor
+{
+public:
+	enum class Format
+	{
+		BC1, // 8 bytes per block. pixels with alpha below 128 become transparent
+		BC3, // 16 bytes per block
+		ETC1, // 8 bytes per block. no alpha
+	};
+	enum class Quality
+	{
+		Fast, // bounding box endpoints (BC1/BC3) or a single sub-block layout (ETC1)
+		Normal, // principal axis endpoints (BC1/BC3) or both sub-block layouts (ETC1)
+		High, // also refines endpoints by least squares (BC1/BC3) or tries both colour modes (ETC1)
+	};
+
+	static std::size_t getBlockSize(Format format); // in bytes
+	static std::size_t getRequiredSize(Xy size, Format format); // in bytes
+	static std::vector<std::size_t> compress(const Image& image, std::uint8_t* destination, std::size_t destinationSize, Format format, Quality quality = Quality::Normal, const Atlas& atlas = Atlas{}); // returns the indices of blocks that straddle a tile's edge (tiles must not overlap)
+
+private:
+	using Block = std::array<Pixel, 16u>; // row by row
+
+	enum class BlockType
+	{
+		Padding,
+		Tile,
+		Straddling,
+	};
+
+	static std::vector<BlockType> priv_getBlockTypes(Xy size, const Atlas& atlas);
+	static Block priv_readBlock(const Image& image, Xy blockPosition);
+	static void priv_compressBc1(const Block& block, std::uint8_t* destination, Quality quality, bool allowTransparency);
+	static std::size_t priv_encodeBc1(const Block& block, std::uint16_t colour0, std::uint16_t colour1, bool hasTransparency, std::uint8_t* destination);
+	static void priv_compressBc3Alpha(const Block& block, std::uint8_t* destination, Quality quality);
+	static void priv_compressEtc1(const Block& block, std::uint8_t* destination, Quality quality);
+	static std::uint16_t priv_toRgb565(const std::array<float, 3u>& colour);
+	static Pixel priv_fromRgb565(std::uint16_t colour);
+	static std::size_t priv_getDistance(const Pixel& a, const Pixel& b); // rgb only
+};
+
+} // namespace sheetimageprocessor
+#include "BlockCompressor.inl"
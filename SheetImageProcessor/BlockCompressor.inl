@@ -0,0 +1,597 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Sheet Image Processor (https://github.com/Hapaxia/SheetImageProcessor
+// --
+//
+// BlockCompressor
+//
+// Copyright(c) 2025-2026 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions :
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software.If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "BlockCompressor.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace sheetimageprocessor
+{
+
+inline std::size_t BlockCompressor::getBlockSize(const Format format)
+{
+	return (format == Format::BC3) ? 16u : 8u;
+}
+
+inline std::size_t BlockCompressor::getRequiredSize(const Xy size, const Format format)
+{
+	return ((size.x + 3u) / 4u) * ((size.y + 3u) / 4u) * getBlockSize(format);
+}
+
+inline std::vector<std::size_t> BlockCompressor::compress(const Image& image, std::uint8_t* destination, const std::size_t destinationSize, const Format format, const Quality quality, const Atlas& atlas)
+{
+	const Xy size{ image.getSize() };
+	if (destinationSize < getRequiredSize(size, format))
+		throw Exception("Cannot compress blocks: destination is too small.");
+	if ((size.x == 0u) || (size.y == 0u))
+		return {};
+
+	const Xy numberOfBlocks{ (size.x + 3u) / 4u, (size.y + 3u) / 4u };
+	const std::size_t blockSize{ getBlockSize(format) };
+	const std::vector<BlockType> blockTypes{ priv_getBlockTypes(size, atlas) };
+
+	// a row of blocks per job
+	Parallel::forEach(numberOfBlocks.y, [&](const std::size_t blockY)
+	{
+		for (std::size_t blockX{ 0u }; blockX < numberOfBlocks.x; ++blockX)
+		{
+			const std::size_t blockIndex{ (blockY * numberOfBlocks.x) + blockX };
+			Block block{ priv_readBlock(image, { blockX * 4u, blockY * 4u }) };
+			Quality blockQuality{ quality };
+			if (blockTypes[blockIndex] == BlockType::Padding)
+			{
+				std::array<std::size_t, 4u> sums{};
+				for (const Pixel& pixel : block)
+				{
+					sums[0u] += pixel.r;
+					sums[1u] += pixel.g;
+					sums[2u] += pixel.b;
+					sums[3u] += pixel.a;
+				}
+				block.fill({ static_cast<std::uint8_t>((sums[0u] + 8u) / 16u), static_cast<std::uint8_t>((sums[1u] + 8u) / 16u), static_cast<std::uint8_t>((sums[2u] + 8u) / 16u), static_cast<std::uint8_t>((sums[3u] + 8u) / 16u) });
+				blockQuality = Quality::Fast;
+			}
+
+			std::uint8_t* blockDestination{ destination + (blockIndex * blockSize) };
+			switch (format)
+			{
+			case Format::BC1:
+				priv_compressBc1(block, blockDestination, blockQuality, true);
+				break;
+			case Format::BC3:
+				priv_compressBc3Alpha(block, blockDestination, blockQuality);
+				priv_compressBc1(block, blockDestination + 8u, blockQuality, false);
+				break;
+			case Format::ETC1:
+				priv_compressEtc1(block, blockDestination, blockQuality);
+				break;
+			}
+		}
+	});
+
+	std::vector<std::size_t> straddlingBlocks{};
+	for (std::size_t i{ 0u }; i < blockTypes.size(); ++i)
+	{
+		if (blockTypes[i] == BlockType::Straddling)
+			straddlingBlocks.push_back(i);
+	}
+	return straddlingBlocks;
+}
+
+inline std::vector<BlockCompressor::BlockType> BlockCompressor::priv_getBlockTypes(const Xy size, const Atlas& atlas)
+{
+	const Xy numberOfBlocks{ (size.x + 3u) / 4u, (size.y + 3u) / 4u };
+	const std::size_t totalNumberOfBlocks{ numberOfBlocks.x * numberOfBlocks.y };
+	if (atlas.getSize() == 0u)
+		return std::vector<BlockType>(totalNumberOfBlocks, BlockType::Tile);
+
+	// count the tile pixels in each block and which tile they belong to
+	constexpr std::size_t noTile{ std::numeric_limits<std::size_t>::max() };
+	std::vector<std::size_t> owners(totalNumberOfBlocks, noTile);
+	std::vector<std::size_t> numberOfTilePixels(totalNumberOfBlocks, 0u);
+	std::vector<BlockType> blockTypes(totalNumberOfBlocks, BlockType::Padding);
+	const std::vector<Atlas::Tile>& tiles{ atlas.constAccess() };
+	for (std::size_t tileIndex{ 0u }; tileIndex < tiles.size(); ++tileIndex)
+	{
+		const Rect rect{ tiles[tileIndex].rect };
+		if ((rect.size.x == 0u) || (rect.size.y == 0u) || (rect.position.x >= size.x) || (rect.position.y >= size.y))
+			continue;
+		const Xy end{ std::min(rect.position.x + rect.size.x, size.x), std::min(rect.position.y + rect.size.y, size.y) };
+		for (std::size_t blockY{ rect.position.y / 4u }; blockY <= ((end.y - 1u) / 4u); ++blockY)
+		{
+			for (std::size_t blockX{ rect.position.x / 4u }; blockX <= ((end.x - 1u) / 4u); ++blockX)
+			{
+				const std::size_t blockIndex{ (blockY * numberOfBlocks.x) + blockX };
+				const std::size_t width{ std::min(end.x, (blockX + 1u) * 4u) - std::max(rect.position.x, blockX * 4u) };
+				const std::size_t height{ std::min(end.y, (blockY + 1u) * 4u) - std::max(rect.position.y, blockY * 4u) };
+				numberOfTilePixels[blockIndex] += width * height;
+				if (owners[blockIndex] == noTile)
+					owners[blockIndex] = tileIndex;
+				else if (owners[blockIndex] != tileIndex)
+					blockTypes[blockIndex] = BlockType::Straddling;
+			}
+		}
+	}
+
+	// a block straddles unless all of its pixels (within the image) are from one tile
+	for (std::size_t blockIndex{ 0u }; blockIndex < totalNumberOfBlocks; ++blockIndex)
+	{
+		if ((owners[blockIndex] == noTile) || (blockTypes[blockIndex] == BlockType::Straddling))
+			continue;
+		const Xy blockPosition{ (blockIndex % numberOfBlocks.x) * 4u, (blockIndex / numberOfBlocks.x) * 4u };
+		const std::size_t numberOfPixels{ std::min(std::size_t{ 4u }, size.x - blockPosition.x) * std::min(std::size_t{ 4u }, size.y - blockPosition.y) };
+		blockTypes[blockIndex] = (numberOfTilePixels[blockIndex] < numberOfPixels) ? BlockType::Straddling : BlockType::Tile;
+	}
+	return blockTypes;
+}
+
+inline BlockCompressor::Block BlockCompressor::priv_readBlock(const Image& image, const Xy blockPosition)
+{
+	const Xy size{ image.getSize() };
+	Block block{};
+	for (std::size_t y{ 0u }; y < 4u; ++y)
+	{
+		for (std::size_t x{ 0u }; x < 4u; ++x)
+			block[(y * 4u) + x] = image.getPixel({ std::min(blockPosition.x + x, size.x - 1u), std::min(blockPosition.y + y, size.y - 1u) });
+	}
+	return block;
+}
+
+inline void BlockCompressor::priv_compressBc1(const Block& block, std::uint8_t* destination, const Quality quality, const bool allowTransparency)
+{
+	// endpoints are found from the opaque pixels only (transparent pixels use their own index)
+	std::vector<std::array<float, 3u>> colours{};
+	colours.reserve(16u);
+	bool hasTransparency{ false };
+	for (const Pixel& pixel : block)
+	{
+		if (allowTransparency && (pixel.a < 128u))
+			hasTransparency = true;
+		else
+			colours.push_back({ static_cast<float>(pixel.r), static_cast<float>(pixel.g), static_cast<float>(pixel.b) });
+	}
+	if (colours.empty())
+	{
+		priv_encodeBc1(block, 0u, 0u, true, destination);
+		return;
+	}
+
+	std::array<float, 3u> minimum{ colours[0u] };
+	std::array<float, 3u> maximum{ colours[0u] };
+	std::array<float, 3u> mean{};
+	for (const std::array<float, 3u>& colour : colours)
+	{
+		for (std::size_t c{ 0u }; c < 3u; ++c)
+		{
+			minimum[c] = std::min(minimum[c], colour[c]);
+			maximum[c] = std::max(maximum[c], colour[c]);
+			mean[c] += colour[c] / static_cast<float>(colours.size());
+		}
+	}
+
+	std::array<float, 3u> endpoint0{ maximum };
+	std::array<float, 3u> endpoint1{ minimum };
+	if (quality == Quality::Fast)
+	{
+		// bounding box, inset slightly so that the endpoints are not wasted on outliers
+		for (std::size_t c{ 0u }; c < 3u; ++c)
+		{
+			const float inset{ (maximum[c] - minimum[c]) / 16.f };
+			endpoint0[c] -= inset;
+			endpoint1[c] += inset;
+		}
+	}
+	else
+	{
+		// principal axis (by power iteration on the covariance) through the mean, clipped to the colours' extent along it
+		std::array<float, 6u> covariance{}; // rr, rg, rb, gg, gb, bb
+		for (const std::array<float, 3u>& colour : colours)
+		{
+			const std::array<float, 3u> d{ colour[0u] - mean[0u], colour[1u] - mean[1u], colour[2u] - mean[2u] };
+			covariance[0u] += d[0u] * d[0u];
+			covariance[1u] += d[0u] * d[1u];
+			covariance[2u] += d[0u] * d[2u];
+			covariance[3u] += d[1u] * d[1u];
+			covariance[4u] += d[1u] * d[2u];
+			covariance[5u] += d[2u] * d[2u];
+		}
+		std::array<float, 3u> axis{ maximum[0u] - minimum[0u], maximum[1u] - minimum[1u], maximum[2u] - minimum[2u] };
+		for (std::size_t iteration{ 0u }; iteration < 8u; ++iteration)
+		{
+			const std::array<float, 3u> next{
+				(covariance[0u] * axis[0u]) + (covariance[1u] * axis[1u]) + (covariance[2u] * axis[2u]),
+				(covariance[1u] * axis[0u]) + (covariance[3u] * axis[1u]) + (covariance[4u] * axis[2u]),
+				(covariance[2u] * axis[0u]) + (covariance[4u] * axis[1u]) + (covariance[5u] * axis[2u]) };
+			const float length{ std::sqrt((next[0u] * next[0u]) + (next[1u] * next[1u]) + (next[2u] * next[2u])) };
+			if (length < 1e-6f)
+				break;
+			axis = { next[0u] / length, next[1u] / length, next[2u] / length };
+		}
+		const float axisLength{ std::sqrt((axis[0u] * axis[0u]) + (axis[1u] * axis[1u]) + (axis[2u] * axis[2u])) };
+		if (axisLength > 1e-6f)
+		{
+			axis = { axis[0u] / axisLength, axis[1u] / axisLength, axis[2u] / axisLength };
+			float minimumT{ 0.f };
+			float maximumT{ 0.f };
+			for (const std::array<float, 3u>& colour : colours)
+			{
+				const float t{ ((colour[0u] - mean[0u]) * axis[0u]) + ((colour[1u] - mean[1u]) * axis[1u]) + ((colour[2u] - mean[2u]) * axis[2u]) };
+				minimumT = std::min(minimumT, t);
+				maximumT = std::max(maximumT, t);
+			}
+			for (std::size_t c{ 0u }; c < 3u; ++c)
+			{
+				endpoint0[c] = mean[c] + (axis[c] * maximumT);
+				endpoint1[c] = mean[c] + (axis[c] * minimumT);
+			}
+		}
+	}
+
+	std::array<std::uint8_t, 8u> best{};
+	std::size_t bestError{ priv_encodeBc1(block, priv_toRgb565(endpoint0), priv_toRgb565(endpoint1), hasTransparency, best.data()) };
+
+	// least squares: with the indices fixed, solve for the endpoints that best fit the pixels
+	if ((quality == Quality::High) && !hasTransparency)
+	{
+		for (std::size_t iteration{ 0u }; iteration < 2u; ++iteration)
+		{
+			std::uint32_t indices{};
+			std::memcpy(&indices, best.data() + 4u, 4u);
+			std::uint16_t colour0{};
+			std::uint16_t colour1{};
+			std::memcpy(&colour0, best.data(), 2u);
+			std::memcpy(&colour1, best.data() + 2u, 2u);
+			if (colour0 <= colour1)
+				break;
+			constexpr std::array<float, 4u> weights{ 1.f, 0.f, 2.f / 3.f, 1.f / 3.f }; // of endpoint 0 for each index
+			float aa{ 0.f };
+			float ab{ 0.f };
+			float bb{ 0.f };
+			std::array<float, 3u> ax{};
+			std::array<float, 3u> bx{};
+			for (std::size_t i{ 0u }; i < 16u; ++i)
+			{
+				const float a{ weights[(indices >> (i * 2u)) & 3u] };
+				const float b{ 1.f - a };
+				aa += a * a;
+				ab += a * b;
+				bb += b * b;
+				const std::array<float, 3u> x{ static_cast<float>(block[i].r), static_cast<float>(block[i].g), static_cast<float>(block[i].b) };
+				for (std::size_t c{ 0u }; c < 3u; ++c)
+				{
+					ax[c] += a * x[c];
+					bx[c] += b * x[c];
+				}
+			}
+			const float determinant{ (aa * bb) - (ab * ab) };
+			if (std::abs(determinant) < 1e-6f)
+				break;
+			for (std::size_t c{ 0u }; c < 3u; ++c)
+			{
+				endpoint0[c] = std::clamp(((ax[c] * bb) - (bx[c] * ab)) / determinant, 0.f, 255.f);
+				endpoint1[c] = std::clamp(((bx[c] * aa) - (ax[c] * ab)) / determinant, 0.f, 255.f);
+			}
+			std::array<std::uint8_t, 8u> refined{};
+			const std::size_t error{ priv_encodeBc1(block, priv_toRgb565(endpoint0), priv_toRgb565(endpoint1), false, refined.data()) };
+			if (error >= bestError)
+				break;
+			bestError = error;
+			best = refined;
+		}
+	}
+	std::memcpy(destination, best.data(), best.size());
+}
+
+inline std::size_t BlockCompressor::priv_encodeBc1(const Block& block, std::uint16_t colour0, std::uint16_t colour1, const bool hasTransparency, std::uint8_t* destination)
+{
+	// four colours need colour0 > colour1. three colours and transparency need colour0 <= colour1
+	if (hasTransparency ? (colour0 > colour1) : (colour0 < colour1))
+		std::swap(colour0, colour1);
+	const bool isFourColours{ colour0 > colour1 };
+
+	std::array<Pixel, 4u> palette{ priv_fromRgb565(colour0), priv_fromRgb565(colour1) };
+	auto mix = [](const std::uint8_t a, const std::uint8_t b, const unsigned int weightA, const unsigned int weightB)
+	{
+		return static_cast<std::uint8_t>(((a * weightA) + (b * weightB)) / (weightA + weightB));
+	};
+	if (isFourColours)
+	{
+		palette[2u] = { mix(palette[0u].r, palette[1u].r, 2u, 1u), mix(palette[0u].g, palette[1u].g, 2u, 1u), mix(palette[0u].b, palette[1u].b, 2u, 1u), 255u };
+		palette[3u] = { mix(palette[0u].r, palette[1u].r, 1u, 2u), mix(palette[0u].g, palette[1u].g, 1u, 2u), mix(palette[0u].b, palette[1u].b, 1u, 2u), 255u };
+	}
+	else
+		palette[2u] = { mix(palette[0u].r, palette[1u].r, 1u, 1u), mix(palette[0u].g, palette[1u].g, 1u, 1u), mix(palette[0u].b, palette[1u].b, 1u, 1u), 255u };
+	const std::size_t numberOfColours{ isFourColours ? 4u : 3u };
+
+	std::uint32_t indices{ 0u };
+	std::size_t totalError{ 0u };
+	for (std::size_t i{ 0u }; i < 16u; ++i)
+	{
+		std::uint32_t index{ 3u };
+		if (!hasTransparency || (block[i].a >= 128u))
+		{
+			std::size_t nearestError{ std::numeric_limits<std::size_t>::max() };
+			for (std::size_t p{ 0u }; p < numberOfColours; ++p)
+			{
+				const std::size_t error{ priv_getDistance(block[i], palette[p]) };
+				if (error < nearestError)
+				{
+					nearestError = error;
+					index = static_cast<std::uint32_t>(p);
+				}
+			}
+			totalError += nearestError;
+		}
+		indices |= index << (i * 2u);
+	}
+
+	// little-endian
+	destination[0u] = static_cast<std::uint8_t>(colour0);
+	destination[1u] = static_cast<std::uint8_t>(colour0 >> 8u);
+	destination[2u] = static_cast<std::uint8_t>(colour1);
+	destination[3u] = static_cast<std::uint8_t>(colour1 >> 8u);
+	for (std::size_t i{ 0u }; i < 4u; ++i)
+		destination[4u + i] = static_cast<std::uint8_t>(indices >> (i * 8u));
+	return totalError;
+}
+
+inline void BlockCompressor::priv_compressBc3Alpha(const Block& block, std::uint8_t* destination, const Quality quality)
+{
+	int minimum{ 255 };
+	int maximum{ 0 };
+	int innerMinimum{ 255 }; // ignoring 0 and 255
+	int innerMaximum{ 0 };
+	for (const Pixel& pixel : block)
+	{
+		minimum = std::min(minimum, static_cast<int>(pixel.a));
+		maximum = std::max(maximum, static_cast<int>(pixel.a));
+		if ((pixel.a > 0u) && (pixel.a < 255u))
+		{
+			innerMinimum = std::min(innerMinimum, static_cast<int>(pixel.a));
+			innerMaximum = std::max(innerMaximum, static_cast<int>(pixel.a));
+		}
+	}
+
+	// alpha0 > alpha1 gives eight interpolated values. otherwise six, plus 0 and 255
+	auto encode = [&](const int alpha0, const int alpha1, std::array<std::uint8_t, 8u>& result)
+	{
+		std::array<int, 8u> palette{ alpha0, alpha1 };
+		if (alpha0 > alpha1)
+		{
+			for (int i{ 1 }; i < 7; ++i)
+				palette[i + 1] = (((7 - i) * alpha0) + (i * alpha1)) / 7;
+		}
+		else
+		{
+			for (int i{ 1 }; i < 5; ++i)
+				palette[i + 1] = (((5 - i) * alpha0) + (i * alpha1)) / 5;
+			palette[6u] = 0;
+			palette[7u] = 255;
+		}
+		std::uint64_t indices{ 0u };
+		std::size_t totalError{ 0u };
+		for (std::size_t i{ 0u }; i < 16u; ++i)
+		{
+			std::uint64_t index{ 0u };
+			int nearestError{ std::numeric_limits<int>::max() };
+			for (std::size_t p{ 0u }; p < 8u; ++p)
+			{
+				const int error{ std::abs(static_cast<int>(block[i].a) - palette[p]) };
+				if (error < nearestError)
+				{
+					nearestError = error;
+					index = p;
+				}
+			}
+			totalError += static_cast<std::size_t>(nearestError * nearestError);
+			indices |= index << (i * 3u);
+		}
+		result[0u] = static_cast<std::uint8_t>(alpha0);
+		result[1u] = static_cast<std::uint8_t>(alpha1);
+		for (std::size_t i{ 0u }; i < 6u; ++i)
+			result[2u + i] = static_cast<std::uint8_t>(indices >> (i * 8u));
+		return totalError;
+	};
+
+	std::array<std::uint8_t, 8u> best{};
+	std::size_t bestError{ encode(maximum, minimum, best) };
+	const bool hasExtremes{ (minimum == 0) || (maximum == 255) };
+	if ((quality != Quality::Fast) && hasExtremes && (bestError > 0u))
+	{
+		std::array<std::uint8_t, 8u> sixValues{};
+		const std::size_t error{ (innerMinimum <= innerMaximum) ? encode(innerMinimum, innerMaximum, sixValues) : encode(0, 0, sixValues) };
+		if (error < bestError)
+			best = sixValues;
+	}
+	std::memcpy(destination, best.data(), best.size());
+}
+
+inline void BlockCompressor::priv_compressEtc1(const Block& block, std::uint8_t* destination, const Quality quality)
+{
+	constexpr std::array<std::array<int, 2u>, 8u> modifierTables{ { { 2, 8 }, { 5, 17 }, { 9, 29 }, { 13, 42 }, { 18, 60 }, { 24, 80 }, { 33, 106 }, { 47, 183 } } };
+	constexpr std::array<int, 4u> modifierSigns{ 1, 1, -1, -1 }; // index (msb, lsb) 0: +small, 1: +large, 2: -small, 3: -large
+
+	// sub-block 0 is the left half (not flipped) or the top half (flipped)
+	auto isInSubBlock1 = [](const std::size_t i, const bool isFlipped) { return isFlipped ? ((i / 4u) >= 2u) : ((i % 4u) >= 2u); };
+
+	// chooses the best modifier table and indices for a sub-block with the given base colour
+	struct SubBlockResult
+	{
+		std::size_t error;
+		std::uint32_t table;
+		std::uint32_t indexBits; // msbs in the top 16 bits, lsbs in the bottom 16
+	};
+	auto encodeSubBlock = [&](const std::array<int, 3u>& base, const bool isFlipped, const bool subBlock)
+	{
+		SubBlockResult best{ std::numeric_limits<std::size_t>::max(), 0u, 0u };
+		for (std::uint32_t table{ 0u }; table < 8u; ++table)
+		{
+			SubBlockResult result{ 0u, table, 0u };
+			for (std::size_t i{ 0u }; i < 16u; ++i)
+			{
+				if (isInSubBlock1(i, isFlipped) != subBlock)
+					continue;
+				std::size_t nearestError{ std::numeric_limits<std::size_t>::max() };
+				std::uint32_t nearestIndex{ 0u };
+				for (std::uint32_t index{ 0u }; index < 4u; ++index)
+				{
+					const int modifier{ modifierSigns[index] * modifierTables[table][index & 1u] };
+					const Pixel colour{ static_cast<std::uint8_t>(std::clamp(base[0u] + modifier, 0, 255)), static_cast<std::uint8_t>(std::clamp(base[1u] + modifier, 0, 255)), static_cast<std::uint8_t>(std::clamp(base[2u] + modifier, 0, 255)), 255u };
+					const std::size_t error{ priv_getDistance(block[i], colour) };
+					if (error < nearestError)
+					{
+						nearestError = error;
+						nearestIndex = index;
+					}
+				}
+				result.error += nearestError;
+
+				// pixels are numbered down each column
+				const std::size_t pixelNumber{ ((i % 4u) * 4u) + (i / 4u) };
+				result.indexBits |= ((nearestIndex >> 1u) << (16u + pixelNumber)) | ((nearestIndex & 1u) << pixelNumber);
+			}
+			if (result.error < best.error)
+				best = result;
+		}
+		return best;
+	};
+
+	std::uint64_t bestWord{ 0u };
+	std::size_t bestError{ std::numeric_limits<std::size_t>::max() };
+	for (std::size_t flip{ 0u }; flip < ((quality == Quality::Fast) ? 1u : 2u); ++flip)
+	{
+		const bool isFlipped{ flip == 1u };
+		std::array<std::array<int, 3u>, 2u> sums{};
+		for (std::size_t i{ 0u }; i < 16u; ++i)
+		{
+			std::array<int, 3u>& sum{ sums[isInSubBlock1(i, isFlipped) ? 1u : 0u] };
+			sum[0u] += block[i].r;
+			sum[1u] += block[i].g;
+			sum[2u] += block[i].b;
+		}
+
+		// differential mode: 5-bit base colours no more than a 3-bit (signed) difference apart
+		std::array<std::array<int, 3u>, 2u> colours5{};
+		bool canBeDifferential{ true };
+		for (std::size_t c{ 0u }; c < 3u; ++c)
+		{
+			colours5[0u][c] = ((sums[0u][c] * 31) + (8 * 255 / 2)) / (8 * 255);
+			colours5[1u][c] = ((sums[1u][c] * 31) + (8 * 255 / 2)) / (8 * 255);
+			const int difference{ colours5[1u][c] - colours5[0u][c] };
+			canBeDifferential = canBeDifferential && (difference >= -4) && (difference <= 3);
+		}
+
+		for (std::size_t mode{ 0u }; mode < 2u; ++mode)
+		{
+			const bool isDifferential{ mode == 0u };
+			if (isDifferential && !canBeDifferential)
+				continue;
+			if (!isDifferential && canBeDifferential && (quality != Quality::High))
+				continue;
+
+			std::array<std::array<int, 3u>, 2u> bases{};
+			std::array<std::array<int, 3u>, 2u> colours4{};
+			for (std::size_t s{ 0u }; s < 2u; ++s)
+			{
+				for (std::size_t c{ 0u }; c < 3u; ++c)
+				{
+					if (isDifferential)
+						bases[s][c] = (colours5[s][c] << 3) | (colours5[s][c] >> 2);
+					else
+					{
+						colours4[s][c] = ((sums[s][c] * 15) + (8 * 255 / 2)) / (8 * 255);
+						bases[s][c] = (colours4[s][c] << 4) | colours4[s][c];
+					}
+				}
+			}
+			const SubBlockResult subBlock0{ encodeSubBlock(bases[0u], isFlipped, false) };
+			const SubBlockResult subBlock1{ encodeSubBlock(bases[1u], isFlipped, true) };
+			const std::size_t error{ subBlock0.error + subBlock1.error };
+			if (error >= bestError)
+				continue;
+
+			std::uint64_t word{ 0u };
+			for (std::size_t c{ 0u }; c < 3u; ++c)
+			{
+				const std::size_t shift{ 59u - (c * 8u) };
+				if (isDifferential)
+				{
+					const int difference{ colours5[1u][c] - colours5[0u][c] };
+					word |= (static_cast<std::uint64_t>(colours5[0u][c]) << shift) | (static_cast<std::uint64_t>(difference & 7) << (shift - 3u));
+				}
+				else
+					word |= (static_cast<std::uint64_t>(colours4[0u][c]) << (shift + 1u)) | (static_cast<std::uint64_t>(colours4[1u][c]) << (shift - 3u));
+			}
+			word |= static_cast<std::uint64_t>(subBlock0.table) << 37u;
+			word |= static_cast<std::uint64_t>(subBlock1.table) << 34u;
+			word |= static_cast<std::uint64_t>(isDifferential ? 1u : 0u) << 33u;
+			word |= static_cast<std::uint64_t>(isFlipped ? 1u : 0u) << 32u;
+			word |= subBlock0.indexBits | subBlock1.indexBits;
+			bestWord = word;
+			bestError = error;
+		}
+	}
+
+	// big-endian
+	for (std::size_t i{ 0u }; i < 8u; ++i)
+		destination[i] = static_cast<std::uint8_t>(bestWord >> (56u - (i * 8u)));
+}
+
+inline std::uint16_t BlockCompressor::priv_toRgb565(const std::array<float, 3u>& colour)
+{
+	const int r{ std::clamp(static_cast<int>(((colour[0u] * 31.f) / 255.f) + 0.5f), 0, 31) };
+	const int g{ std::clamp(static_cast<int>(((colour[1u] * 63.f) / 255.f) + 0.5f), 0, 63) };
+	const int b{ std::clamp(static_cast<int>(((colour[2u] * 31.f) / 255.f) + 0.5f), 0, 31) };
+	return static_cast<std::uint16_t>((r << 11) | (g << 5) | b);
+}
+
+inline Pixel BlockCompressor::priv_fromRgb565(const std::uint16_t colour)
+{
+	const std::uint8_t r{ static_cast<std::uint8_t>((colour >> 11u) & 31u) };
+	const std::uint8_t g{ static_cast<std::uint8_t>((colour >> 5u) & 63u) };
+	const std::uint8_t b{ static_cast<std::uint8_t>(colour & 31u) };
+	return { static_cast<std::uint8_t>((r << 3u) | (r >> 2u)), static_cast<std::uint8_t>((g << 2u) | (g >> 4u)), static_cast<std::uint8_t>((b << 3u) | (b >> 2u)), 255u };
+}
+
+inline std::size_t BlockCompressor::priv_getDistance(const Pixel& a, const Pixel& b)
+{
+	const int differenceR{ static_cast<int>(a.r) - static_cast<int>(b.r) };
+	const int differenceG{ static_cast<int>(a.g) - static_cast<int>(b.g) };
+	const int differenceB{ static_cast<int>(a.b) - static_cast<int>(b.b) };
+	return static_cast<std::size_t>((differenceR * differenceR) + (differenceG * differenceG) + (differenceB * differenceB));
+}
+
+} // namespace sheetimageprocessor
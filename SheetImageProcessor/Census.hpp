@@ -0,0 +1,74 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Sheet Image Processor (https://github.com/Hapaxia/SheetImageProcessor
+// --
+//
+// Census
+//
+// Copyright(c) 2025-2026 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions :
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software.If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Common.hpp"
+#include "Image.hpp"
+#include "Atlas.hpp"
+#include "ColourMap.hpp"
+
+namespace sheetimageprocessor
+{
+
+// counts the colours of a rect or of each tile of an atlas (as they read, in RGBA): the exact number of distinct colours, the most frequent colours and a histogram of each channel
+class Census
+{
+public:
+	struct Result
+	{
+		std::size_t numberOfPixels{ 0u };
+		std::size_t numberOfColours{ 0u }; // distinct colours
+		std::vector<std::pair<Pixel, std::size_t>> topColours{}; // (colour, number of pixels), most frequent first
+		std::array<std::array<std::size_t, 256u>, 4u> histograms{}; // number of pixels with each value of r, g, b and a (histograms[3u] is alpha)
+	};
+
+	static Result count(const Image& image, Rect rect = Rect{}, std::size_t numberOfTopColours = 16u);
+	static std::vector<Result> count(const Image& image, const Atlas& atlas, Result& total, std::size_t numberOfTopColours = 16u); // a result for each tile. total counts all of the tiles together (pixels in overlapping tiles are counted for each)
+
+private:
+	static constexpr std::size_t m_numberOfRowsPerJob{ 32u };
+
+	struct Partial // counts from any number of pixels
+	{
+		ColourMap<std::size_t> counts{};
+		Result result{};
+	};
+
+	static void priv_countRows(const Image& image, Rect rect, Partial& partial); // rect must be within the image
+	static void priv_merge(Partial& partial, const Partial& other);
+	static Result priv_finish(Partial& partial, std::size_t numberOfTopColours);
+	static bool priv_clipRect(const Image& image, Rect& rect);
+};
+
+} // namespace sheetimageprocessor
+#include "Census.inl"
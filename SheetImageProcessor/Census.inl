@@ -0,0 +1,177 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Sheet Image Processor (https://github.com/Hapaxia/SheetImageProcessor
+// --
+//
+// Census
+//
+// Copyright(c) 2025-2026 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions :
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software.If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "Census.hpp"
+
+#include <algorithm>
+
+namespace sheetimageprocessor
+{
+
+inline Census::Result Census::count(const Image& image, Rect rect, const std::size_t numberOfTopColours)
+{
+	if ((rect.size.x == 0u) || (rect.size.y == 0u))
+		rect = { { 0u, 0u }, image.getSize() };
+	if (!priv_clipRect(image, rect))
+		return {};
+
+	// bands of rows are counted into their own tables and then merged
+	const std::size_t numberOfJobs{ (rect.size.y + m_numberOfRowsPerJob - 1u) / m_numberOfRowsPerJob };
+	std::vector<Partial> partials(numberOfJobs);
+	Parallel::forEach(numberOfJobs, [&](const std::size_t jobIndex)
+	{
+		const std::size_t firstRow{ jobIndex * m_numberOfRowsPerJob };
+		const std::size_t numberOfRows{ std::min(m_numberOfRowsPerJob, rect.size.y - firstRow) };
+		priv_countRows(image, { { rect.position.x, rect.position.y + firstRow }, { rect.size.x, numberOfRows } }, partials[jobIndex]);
+	});
+	for (std::size_t i{ 1u }; i < partials.size(); ++i)
+		priv_merge(partials[0u], partials[i]);
+	return priv_finish(partials[0u], numberOfTopColours);
+}
+
+inline std::vector<Census::Result> Census::count(const Image& image, const Atlas& atlas, Result& total, const std::size_t numberOfTopColours)
+{
+	// tiles are shared out between one job per thread. each tile is counted into its own table, which is merged into the job's total as soon as the tile is finished, so only one table per job (rather than per tile) is kept
+	const std::vector<Atlas::Tile>& tiles{ atlas.constAccess() };
+	const std::size_t numberOfJobs{ std::max(std::min(Parallel::getMaxNumberOfThreads(), tiles.size()), std::size_t{ 1u }) };
+	std::vector<Partial> jobTotals(numberOfJobs);
+	std::vector<Result> results(tiles.size());
+	Parallel::forEach(numberOfJobs, [&](const std::size_t jobIndex)
+	{
+		for (std::size_t i{ jobIndex }; i < tiles.size(); i += numberOfJobs)
+		{
+			Rect rect{ tiles[i].rect };
+			if (!priv_clipRect(image, rect))
+				continue;
+			Partial tilePartial{}; // (a new table for each tile so that small tiles do not walk a table sized for a large one)
+			priv_countRows(image, rect, tilePartial);
+			results[i] = priv_finish(tilePartial, numberOfTopColours);
+			priv_merge(jobTotals[jobIndex], tilePartial);
+		}
+	});
+
+	Partial totalPartial{};
+	for (const Partial& jobTotal : jobTotals)
+		priv_merge(totalPartial, jobTotal);
+	total = priv_finish(totalPartial, numberOfTopColours);
+	return results;
+}
+
+inline void Census::priv_countRows(const Image& image, const Rect rect, Partial& partial)
+{
+	// other formats are converted a row at a time
+	const bool isRgba{ image.getPixelFormat() == Image::PixelFormat::RGBA };
+	Image rowImage{};
+	Result& result{ partial.result };
+	for (std::size_t y{ 0u }; y < rect.size.y; ++y)
+	{
+		const Rect rowRect{ { rect.position.x, rect.position.y + y }, { rect.size.x, 1u } };
+		const std::uint8_t* row{ nullptr };
+		if (isRgba)
+			row = image.getRowData(rowRect.position.y) + (rowRect.position.x * 4u);
+		else
+		{
+			rowImage.setSize(rowRect.size, false);
+			rowImage.copy({ 0u, 0u }, image, rowRect);
+			row = rowImage.getRowData(0u);
+		}
+
+		// runs of the same colour are counted together
+		std::uint32_t runKey{ 0u };
+		std::size_t runLength{ 0u };
+		for (std::size_t x{ 0u }; x < rect.size.x; ++x)
+		{
+			const std::uint8_t* pixel{ row + (x * 4u) };
+			for (std::size_t c{ 0u }; c < 4u; ++c)
+				++result.histograms[c][pixel[c]];
+			const std::uint32_t key{ ColourMap<std::size_t>::getKey({ pixel[0u], pixel[1u], pixel[2u], pixel[3u] }) };
+			if ((runLength > 0u) && (key != runKey))
+			{
+				partial.counts[runKey] += runLength;
+				runLength = 0u;
+			}
+			runKey = key;
+			++runLength;
+		}
+		if (runLength > 0u)
+			partial.counts[runKey] += runLength;
+	}
+	result.numberOfPixels += rect.size.x * rect.size.y;
+}
+
+inline void Census::priv_merge(Partial& partial, const Partial& other)
+{
+	other.counts.forEach([&partial](const std::uint32_t key, const std::size_t count) { partial.counts[key] += count; });
+	partial.result.numberOfPixels += other.result.numberOfPixels;
+	for (std::size_t c{ 0u }; c < 4u; ++c)
+	{
+		for (std::size_t value{ 0u }; value < 256u; ++value)
+			partial.result.histograms[c][value] += other.result.histograms[c][value];
+	}
+}
+
+inline Census::Result Census::priv_finish(Partial& partial, const std::size_t numberOfTopColours)
+{
+	Result result{ partial.result };
+	result.numberOfColours = partial.counts.getSize();
+
+	std::vector<std::pair<std::uint32_t, std::size_t>> entries{};
+	entries.reserve(result.numberOfColours);
+	partial.counts.forEach([&entries](const std::uint32_t key, const std::size_t count) { entries.emplace_back(key, count); });
+	const std::size_t numberOfTop{ std::min(numberOfTopColours, entries.size()) };
+	std::partial_sort(entries.begin(), entries.begin() + numberOfTop, entries.end(), [](const auto& lhs, const auto& rhs)
+	{
+		if (lhs.second != rhs.second)
+			return (lhs.second > rhs.second);
+		return (lhs.first < rhs.first);
+	});
+	result.topColours.reserve(numberOfTop);
+	for (std::size_t i{ 0u }; i < numberOfTop; ++i)
+	{
+		const std::uint32_t key{ entries[i].first };
+		result.topColours.push_back({ { static_cast<std::uint8_t>(key), static_cast<std::uint8_t>(key >> 8u), static_cast<std::uint8_t>(key >> 16u), static_cast<std::uint8_t>(key >> 24u) }, entries[i].second });
+	}
+	return result;
+}
+
+inline bool Census::priv_clipRect(const Image& image, Rect& rect)
+{
+	const Xy size{ image.getSize() };
+	if ((rect.position.x >= size.x) || (rect.position.y >= size.y))
+		return false;
+	rect.size.x = std::min(rect.size.x, size.x - rect.position.x);
+	rect.size.y = std::min(rect.size.y, size.y - rect.position.y);
+	return ((rect.size.x > 0u) && (rect.size.y > 0u));
+}
+
+} // namespace sheetimageprocessor
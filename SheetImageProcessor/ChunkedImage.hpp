@@ -0,0 +1,125 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Sheet Image Processor (https://github.com/Hapaxia/SheetImageProcessor
+// --
+//
+// ChunkedImage
+//
+// Copyright(c) 2025-2026 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions :
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software.If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Common.hpp"
+#include "Image.hpp"
+#include "Atlas.hpp"
+#include "ScratchPool.hpp"
+
+#include <fstream>
+#include <list>
+#include <memory>
+
+namespace sheetimageprocessor
+{
+
+// an image stored as a grid of fixed-size chunks, for sheets too large to keep in memory or mostly left clear.
+// chunks that have never been written take no memory (and no storage): they read as the clear pixel.
+// without storage, written chunks stay in memory (a sparse image). with storage set, only as many chunks as fit in the memory budget are kept in memory; the rest are paged out to the storage file
+class ChunkedImage
+{
+public:
+	ChunkedImage(Xy chunkSize = { 256u, 256u }, Image::PixelFormat pixelFormat = Image::PixelFormat::RGBA);
+	~ChunkedImage();
+	ChunkedImage(const ChunkedImage&) = delete;
+	ChunkedImage& operator=(const ChunkedImage&) = delete;
+
+	void setStorage(const std::string& filename, std::size_t memoryBudget); // memoryBudget is in bytes. the file is created (or emptied) and then removed when this image is destroyed. call before setSize
+	void setSize(Xy size, Pixel clearPixel = Pixel{ 0u, 0u, 0u, 255u });
+	Xy getSize() const;
+	Xy getChunkSize() const;
+	Image::PixelFormat getPixelFormat() const;
+	void setPalette(const std::vector<Pixel>& palette); // used by the Indexed8 format
+	const std::vector<Pixel>& getPalette() const;
+
+	void setPixel(Xy location, Pixel pixel);
+	Pixel getPixel(Xy location) const;
+
+	void clear(Pixel pixel = Pixel{ 0u, 0u, 0u, 255u }); // releases every chunk; they all read as pixel from then on
+	void clear(Rect rect, Pixel pixel = Pixel{ 0u, 0u, 0u, 255u }); // chunks fully inside rect are released if pixel is the clear pixel
+
+	void copy(Xy position, const Image& sourceImage, Rect sourceRect);
+	Rect copy(Xy position, const Image& sourceImage, Rect sourceRect, std::size_t expansion); // position is where the (unexpanded) tile is placed; returns the expanded Rect
+	void copyTo(Image& destinationImage, Xy destinationPosition, Rect rect) const; // rect of this image must fit in destinationImage at destinationPosition
+	Rect expand(Rect rect, std::size_t expansion = 1u); // returns the expanded Rect. NOTE: expanded Rect MUST fit within the image otherwise an exception is thrown
+	void expand(const Atlas& atlas, std::size_t expansion = 1u);
+	bool transfer(const Atlas& atlas, const Image& sourceImage, const Atlas& sourceAtlas, std::size_t amountOfExpansionIncluded = 0u);
+	void trimAtlas(Atlas& atlas, Pixel pixelToTrim = Pixel{ 0u, 0u, 0u, 0u }) const;
+
+	void prefetch(Rect rect) const; // loads the chunks covering rect, as far as the memory budget allows
+	void flush() const; // writes every modified chunk to the storage file
+	std::size_t getNumberOfLoadedChunks() const;
+
+	void materialise(Image& image) const; // copies the entire image into a single (contiguous) image
+	const std::uint8_t* getData() const; // materialises the entire image (kept until this image is next modified)
+
+private:
+	struct Chunk
+	{
+		std::unique_ptr<Image> image{}; // null when not in memory
+		bool isDirty{ false };
+		bool isStored{ false };
+		std::list<std::size_t>::iterator recentlyUsed{};
+	};
+
+	const Xy m_chunkSize;
+	const Image::PixelFormat m_pixelFormat;
+	Xy m_size;
+	Xy m_numberOfChunks;
+	Pixel m_clearPixel;
+	std::vector<Pixel> m_palette;
+	std::string m_filename;
+	std::size_t m_maxNumberOfLoadedChunks;
+	mutable std::fstream m_file;
+	mutable std::vector<Chunk> m_chunks;
+	mutable std::list<std::size_t> m_recentlyUsed; // loaded chunks, most recently used first
+	mutable std::size_t m_lastChunkIndex;
+	mutable ScratchPool m_scratchPool;
+	mutable Image m_materialised;
+	mutable bool m_isMaterialised;
+
+	bool priv_isStorageFile() const;
+	Rect priv_getChunkRect(std::size_t chunkIndex) const;
+	Image& priv_accessChunk(std::size_t chunkIndex, bool willModify) const;
+	void priv_loadChunk(std::size_t chunkIndex) const;
+	void priv_unloadChunk(std::size_t chunkIndex) const;
+	void priv_storeChunk(std::size_t chunkIndex) const;
+	void priv_releaseChunk(std::size_t chunkIndex);
+	void priv_forEachChunk(Rect rect, const std::function<void(std::size_t chunkIndex, Rect chunkRect)>& chunkFunction) const; // chunkRect is the part of rect within the chunk (in image co-ordinates)
+	void priv_prepareImage(Image& image) const;
+	bool priv_fits(Rect rect) const;
+};
+
+} // namespace sheetimageprocessor
+#include "ChunkedImage.inl"
@@ -0,0 +1,472 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Sheet Image Processor (https://github.com/Hapaxia/SheetImageProcessor
+// --
+//
+// ChunkedImage
+//
+// Copyright(c) 2025-2026 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions :
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software.If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "ChunkedImage.hpp"
+
+#include <cstdio>
+
+namespace sheetimageprocessor
+{
+
+inline ChunkedImage::ChunkedImage(const Xy chunkSize, const Image::PixelFormat pixelFormat)
+	: m_chunkSize{ std::max(chunkSize.x, std::size_t{ 1u }), std::max(chunkSize.y, std::size_t{ 1u }) }
+	, m_pixelFormat{ pixelFormat }
+	, m_size{ 0u, 0u }
+	, m_numberOfChunks{ 0u, 0u }
+	, m_clearPixel{ 0u, 0u, 0u, 255u }
+	, m_palette{}
+	, m_filename{}
+	, m_maxNumberOfLoadedChunks{ 0u }
+	, m_file{}
+	, m_chunks{}
+	, m_recentlyUsed{}
+	, m_lastChunkIndex{ 0u }
+	, m_scratchPool{ 2u }
+	, m_materialised{}
+	, m_isMaterialised{ false }
+{
+
+}
+
+inline ChunkedImage::~ChunkedImage()
+{
+	m_chunks.clear();
+	if (m_file.is_open())
+	{
+		m_file.close();
+		std::remove(m_filename.c_str());
+	}
+}
+
+inline void ChunkedImage::setStorage(const std::string& filename, const std::size_t memoryBudget)
+{
+	if (m_file.is_open())
+	{
+		m_file.close();
+		std::remove(m_filename.c_str());
+	}
+	m_filename = filename;
+	m_file.open(m_filename, std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+	if (!m_file.is_open())
+		throw Exception("Cannot create chunk storage file: " + filename);
+
+	// at least two chunks must fit in memory: the one being worked on and the one being read ahead
+	const std::size_t chunkBytes{ m_chunkSize.x * m_chunkSize.y * Image::getNumberOfValuesPerPixel(m_pixelFormat) };
+	m_maxNumberOfLoadedChunks = std::max(memoryBudget / chunkBytes, std::size_t{ 2u });
+	setSize(m_size, m_clearPixel);
+}
+
+inline void ChunkedImage::setSize(const Xy size, const Pixel clearPixel)
+{
+	m_chunks.clear();
+	m_recentlyUsed.clear();
+	m_size = size;
+	m_clearPixel = clearPixel;
+	m_numberOfChunks = { (size.x + m_chunkSize.x - 1u) / m_chunkSize.x, (size.y + m_chunkSize.y - 1u) / m_chunkSize.y };
+	m_chunks.resize(m_numberOfChunks.x * m_numberOfChunks.y);
+	m_lastChunkIndex = 0u;
+	m_isMaterialised = false;
+	m_materialised.setSize({ 0u, 0u });
+}
+
+inline Xy ChunkedImage::getSize() const
+{
+	return m_size;
+}
+
+inline Xy ChunkedImage::getChunkSize() const
+{
+	return m_chunkSize;
+}
+
+inline Image::PixelFormat ChunkedImage::getPixelFormat() const
+{
+	return m_pixelFormat;
+}
+
+inline void ChunkedImage::setPalette(const std::vector<Pixel>& palette)
+{
+	m_palette = palette;
+	for (const std::size_t chunkIndex : m_recentlyUsed)
+		m_chunks[chunkIndex].image->setPalette(m_palette);
+	m_isMaterialised = false;
+}
+
+inline const std::vector<Pixel>& ChunkedImage::getPalette() const
+{
+	return m_palette;
+}
+
+inline void ChunkedImage::setPixel(const Xy location, const Pixel pixel)
+{
+	if ((location.x >= m_size.x) || (location.y >= m_size.y))
+		return;
+	const Xy chunk{ location.x / m_chunkSize.x, location.y / m_chunkSize.y };
+	priv_accessChunk((chunk.y * m_numberOfChunks.x) + chunk.x, true).setPixel(location - (chunk * m_chunkSize), pixel);
+}
+
+inline Pixel ChunkedImage::getPixel(const Xy location) const
+{
+	if ((location.x >= m_size.x) || (location.y >= m_size.y))
+		return {};
+	const Xy chunk{ location.x / m_chunkSize.x, location.y / m_chunkSize.y };
+	const std::size_t chunkIndex{ (chunk.y * m_numberOfChunks.x) + chunk.x };
+	if ((m_chunks[chunkIndex].image == nullptr) && !m_chunks[chunkIndex].isStored)
+		return m_clearPixel;
+	return priv_accessChunk(chunkIndex, false).getPixel(location - (chunk * m_chunkSize));
+}
+
+inline void ChunkedImage::clear(const Pixel pixel)
+{
+	setSize(m_size, pixel);
+}
+
+inline void ChunkedImage::clear(const Rect rect, const Pixel pixel)
+{
+	priv_forEachChunk(rect, [&](const std::size_t chunkIndex, const Rect chunkRect)
+	{
+		const Rect wholeChunkRect{ priv_getChunkRect(chunkIndex) };
+		const bool isWholeChunk{ (chunkRect.size.x == wholeChunkRect.size.x) && (chunkRect.size.y == wholeChunkRect.size.y) };
+		const bool isUnwritten{ (m_chunks[chunkIndex].image == nullptr) && !m_chunks[chunkIndex].isStored };
+		if ((pixel == m_clearPixel) && isUnwritten)
+			return; // an unwritten chunk is already all clear so it is not loaded
+		if ((pixel == m_clearPixel) && isWholeChunk)
+			priv_releaseChunk(chunkIndex);
+		else
+			priv_accessChunk(chunkIndex, true).clear({ chunkRect.position - wholeChunkRect.position, chunkRect.size }, pixel);
+	});
+}
+
+inline void ChunkedImage::copy(const Xy position, const Image& sourceImage, Rect sourceRect)
+{
+	const Xy sourceImageSize{ sourceImage.getSize() };
+	if ((sourceRect.size.x == 0u) || (sourceRect.size.y == 0u))
+		sourceRect.size = sourceImageSize;
+	if (((sourceRect.position.x + sourceRect.size.x) > sourceImageSize.x) || ((sourceRect.position.y + sourceRect.size.y) > sourceImageSize.y))
+		return;
+	if ((position.x >= m_size.x) || (position.y >= m_size.y))
+		return;
+	sourceRect.size.x = std::min(sourceRect.size.x, m_size.x - position.x);
+	sourceRect.size.y = std::min(sourceRect.size.y, m_size.y - position.y);
+
+	priv_forEachChunk({ position, sourceRect.size }, [&](const std::size_t chunkIndex, const Rect chunkRect)
+	{
+		const Rect chunkSourceRect{ sourceRect.position + (chunkRect.position - position), chunkRect.size };
+		priv_accessChunk(chunkIndex, true).copy(chunkRect.position - priv_getChunkRect(chunkIndex).position, sourceImage, chunkSourceRect);
+	});
+}
+
+inline Rect ChunkedImage::copy(const Xy position, const Image& sourceImage, const Rect sourceRect, const std::size_t expansion)
+{
+	if ((position.x < expansion) || (position.y < expansion))
+		return {};
+
+	// the tile is expanded in a scratch image and then written chunk by chunk
+	Image tileImage{};
+	priv_prepareImage(tileImage);
+	tileImage.setSize(sourceRect.size + Xy{ expansion + expansion, expansion + expansion }, false);
+	const Rect expandedRect{ tileImage.copy({ expansion, expansion }, sourceImage, sourceRect, expansion) };
+	if (expandedRect.size.x == 0u)
+		return {};
+	copy(position - Xy{ expansion, expansion }, tileImage, expandedRect);
+	return { position - Xy{ expansion, expansion }, expandedRect.size };
+}
+
+inline void ChunkedImage::copyTo(Image& destinationImage, const Xy destinationPosition, const Rect rect) const
+{
+	if (!priv_fits(rect))
+		return;
+	const Xy destinationSize{ destinationImage.getSize() };
+	if (((destinationPosition.x + rect.size.x) > destinationSize.x) || ((destinationPosition.y + rect.size.y) > destinationSize.y))
+		return;
+
+	priv_forEachChunk(rect, [&](const std::size_t chunkIndex, const Rect chunkRect)
+	{
+		const Xy destination{ destinationPosition + (chunkRect.position - rect.position) };
+		if ((m_chunks[chunkIndex].image == nullptr) && !m_chunks[chunkIndex].isStored)
+			destinationImage.clear({ destination, chunkRect.size }, m_clearPixel);
+		else
+		{
+			const Image& chunkImage{ priv_accessChunk(chunkIndex, false) };
+			destinationImage.copy(destination, chunkImage, { chunkRect.position - priv_getChunkRect(chunkIndex).position, chunkRect.size });
+		}
+	});
+}
+
+inline Rect ChunkedImage::expand(const Rect rect, const std::size_t expansion)
+{
+	const bool doesNotFit{ (rect.position.x < expansion) || (rect.position.y < expansion) || !priv_fits({ rect.position, rect.size + Xy{ expansion, expansion } }) };
+	if (doesNotFit)
+		throw(Exception("expanded rect does not fit inside image."));
+
+	// read the tile, extrude it in a scratch image and write back only the padding
+	const Rect expandedRect{ rect.position - Xy{ expansion, expansion }, rect.size + Xy{ expansion + expansion, expansion + expansion } };
+	if ((expansion == 0u) || (rect.size.x == 0u) || (rect.size.y == 0u))
+		return expandedRect;
+	Image tileImage{};
+	priv_prepareImage(tileImage);
+	tileImage.setSize(expandedRect.size, false);
+	copyTo(tileImage, { expansion, expansion }, rect);
+	tileImage.expand({ { expansion, expansion }, rect.size }, expansion);
+	copy(expandedRect.position, tileImage, { { 0u, 0u }, { expandedRect.size.x, expansion } });
+	copy({ expandedRect.position.x, rect.position.y + rect.size.y }, tileImage, { { 0u, expansion + rect.size.y }, { expandedRect.size.x, expansion } });
+	copy({ expandedRect.position.x, rect.position.y }, tileImage, { { 0u, expansion }, { expansion, rect.size.y } });
+	copy({ rect.position.x + rect.size.x, rect.position.y }, tileImage, { { expansion + rect.size.x, expansion }, { expansion, rect.size.y } });
+	return expandedRect;
+}
+
+inline void ChunkedImage::expand(const Atlas& atlas, const std::size_t expansion)
+{
+	for (const std::size_t i : atlas.getBlitOrder(std::max(m_chunkSize.x, m_chunkSize.y)))
+		expand(atlas.get(i).rect, expansion);
+}
+
+inline bool ChunkedImage::transfer(const Atlas& atlas, const Image& sourceImage, const Atlas& sourceAtlas, const std::size_t amountOfExpansionIncluded)
+{
+	const std::size_t atlasSize{ atlas.getSize() };
+	if (atlasSize != sourceAtlas.getSize())
+		return false;
+
+	// in chunk-sized cells so that each chunk is finished with before moving on to the next
+	for (const std::size_t i : atlas.getBlitOrder(sourceAtlas, std::max(m_chunkSize.x, m_chunkSize.y)))
+		copy(atlas.get(i).rect.position, sourceImage, sourceAtlas.get(i).rect, amountOfExpansionIncluded);
+	return true;
+}
+
+inline void ChunkedImage::trimAtlas(Atlas& atlas, const Pixel pixelToTrim) const
+{
+	// each tile is trimmed from a copy of it at the origin of a scratch image
+	Image tileImage{};
+	priv_prepareImage(tileImage);
+	Atlas tileAtlas{};
+	tileAtlas.resize(1u);
+	const std::size_t numberOfTiles{ atlas.getSize() };
+	for (std::size_t tileIndex{ 0u }; tileIndex < numberOfTiles; ++tileIndex)
+	{
+		Atlas::Tile tile{ atlas.get(tileIndex) };
+		const Xy position{ tile.rect.position };
+		if (priv_fits(tile.rect) && (tile.rect.size.x > 0u) && (tile.rect.size.y > 0u))
+		{
+			tileImage.setSize(tile.rect.size, false);
+			copyTo(tileImage, { 0u, 0u }, tile.rect);
+		}
+		else
+			tileImage.setSize({ 0u, 0u }, false);
+		tile.rect.position = { 0u, 0u };
+		tileAtlas.set(0u, tile);
+		tileImage.trimAtlas(tileAtlas, pixelToTrim);
+		tile = tileAtlas.get(0u);
+		tile.rect.position += position;
+		atlas.set(tileIndex, tile);
+	}
+}
+
+inline void ChunkedImage::prefetch(const Rect rect) const
+{
+	std::size_t numberOfChunksLoaded{ 0u };
+	priv_forEachChunk(rect, [&](const std::size_t chunkIndex, const Rect)
+	{
+		if (priv_isStorageFile() && (numberOfChunksLoaded >= m_maxNumberOfLoadedChunks))
+			return;
+		if (m_chunks[chunkIndex].isStored)
+			priv_accessChunk(chunkIndex, false);
+		++numberOfChunksLoaded;
+	});
+}
+
+inline void ChunkedImage::flush() const
+{
+	if (!priv_isStorageFile())
+		return;
+	const std::size_t numberOfChunks{ m_chunks.size() };
+	for (std::size_t i{ 0u }; i < numberOfChunks; ++i)
+	{
+		if ((m_chunks[i].image != nullptr) && m_chunks[i].isDirty)
+			priv_storeChunk(i);
+	}
+	m_file.flush();
+}
+
+inline std::size_t ChunkedImage::getNumberOfLoadedChunks() const
+{
+	return m_recentlyUsed.size();
+}
+
+inline void ChunkedImage::materialise(Image& image) const
+{
+	image.setPalette(m_palette);
+	image.setPixelFormat(m_pixelFormat, false);
+	image.setSize(m_size, false);
+	copyTo(image, { 0u, 0u }, { { 0u, 0u }, m_size });
+}
+
+inline const std::uint8_t* ChunkedImage::getData() const
+{
+	if (!m_isMaterialised)
+	{
+		materialise(m_materialised);
+		m_isMaterialised = true;
+	}
+	return m_materialised.getData();
+}
+
+inline bool ChunkedImage::priv_isStorageFile() const
+{
+	return m_file.is_open();
+}
+
+inline Rect ChunkedImage::priv_getChunkRect(const std::size_t chunkIndex) const
+{
+	const Xy position{ Xy{ chunkIndex % m_numberOfChunks.x, chunkIndex / m_numberOfChunks.x } * m_chunkSize };
+	return { position, { std::min(m_chunkSize.x, m_size.x - position.x), std::min(m_chunkSize.y, m_size.y - position.y) } };
+}
+
+inline Image& ChunkedImage::priv_accessChunk(const std::size_t chunkIndex, const bool willModify) const
+{
+	Chunk& chunk{ m_chunks[chunkIndex] };
+	if (chunk.image == nullptr)
+	{
+		priv_loadChunk(chunkIndex);
+
+		// read ahead when walking along a row of chunks
+		const std::size_t nextChunkIndex{ chunkIndex + 1u };
+		const bool isWalkingRight{ (chunkIndex == (m_lastChunkIndex + 1u)) && ((nextChunkIndex % m_numberOfChunks.x) != 0u) };
+		if (isWalkingRight && priv_isStorageFile() && m_chunks[nextChunkIndex].isStored && (m_chunks[nextChunkIndex].image == nullptr))
+			priv_loadChunk(nextChunkIndex);
+	}
+	m_recentlyUsed.splice(m_recentlyUsed.begin(), m_recentlyUsed, chunk.recentlyUsed);
+	m_lastChunkIndex = chunkIndex;
+	if (willModify)
+	{
+		chunk.isDirty = true;
+		m_isMaterialised = false;
+	}
+	return *chunk.image;
+}
+
+inline void ChunkedImage::priv_loadChunk(const std::size_t chunkIndex) const
+{
+	if (priv_isStorageFile())
+	{
+		while (m_recentlyUsed.size() >= m_maxNumberOfLoadedChunks)
+			priv_unloadChunk(m_recentlyUsed.back());
+	}
+
+	Chunk& chunk{ m_chunks[chunkIndex] };
+	const Rect chunkRect{ priv_getChunkRect(chunkIndex) };
+	chunk.image = std::make_unique<Image>();
+	priv_prepareImage(*chunk.image);
+	if (chunk.isStored)
+	{
+		chunk.image->setSize(chunkRect.size, false);
+		const std::size_t numberOfValuesPerPixel{ Image::getNumberOfValuesPerPixel(m_pixelFormat) };
+		m_file.seekg(static_cast<std::streamoff>(chunkIndex * m_chunkSize.x * m_chunkSize.y * numberOfValuesPerPixel));
+		m_file.read(reinterpret_cast<char*>(chunk.image->accessRowData(0u)), static_cast<std::streamsize>(chunkRect.size.x * chunkRect.size.y * numberOfValuesPerPixel));
+		if (!m_file)
+			throw Exception("Cannot read chunk from storage file.");
+	}
+	else
+		chunk.image->setSize(chunkRect.size, true, m_clearPixel);
+	chunk.isDirty = false;
+	m_recentlyUsed.push_front(chunkIndex);
+	chunk.recentlyUsed = m_recentlyUsed.begin();
+}
+
+inline void ChunkedImage::priv_unloadChunk(const std::size_t chunkIndex) const
+{
+	Chunk& chunk{ m_chunks[chunkIndex] };
+	if (chunk.isDirty)
+		priv_storeChunk(chunkIndex);
+	chunk.image.reset();
+	m_recentlyUsed.erase(chunk.recentlyUsed);
+}
+
+inline void ChunkedImage::priv_storeChunk(const std::size_t chunkIndex) const
+{
+	// each chunk has a full-size slot in the file (edge chunks leave part of theirs unused)
+	Chunk& chunk{ m_chunks[chunkIndex] };
+	const Xy size{ chunk.image->getSize() };
+	const std::size_t numberOfValuesPerPixel{ Image::getNumberOfValuesPerPixel(m_pixelFormat) };
+	m_file.seekp(static_cast<std::streamoff>(chunkIndex * m_chunkSize.x * m_chunkSize.y * numberOfValuesPerPixel));
+	m_file.write(reinterpret_cast<const char*>(chunk.image->getRowData(0u)), static_cast<std::streamsize>(size.x * size.y * numberOfValuesPerPixel));
+	if (!m_file)
+		throw Exception("Cannot write chunk to storage file.");
+	chunk.isStored = true;
+	chunk.isDirty = false;
+}
+
+inline void ChunkedImage::priv_releaseChunk(const std::size_t chunkIndex)
+{
+	Chunk& chunk{ m_chunks[chunkIndex] };
+	if (chunk.image != nullptr)
+	{
+		chunk.image.reset();
+		m_recentlyUsed.erase(chunk.recentlyUsed);
+	}
+	chunk.isDirty = false;
+	chunk.isStored = false;
+	m_isMaterialised = false;
+}
+
+inline void ChunkedImage::priv_prepareImage(Image& image) const
+{
+	image.setScratchPool(&m_scratchPool);
+	image.setPalette(m_palette);
+	image.setPixelFormat(m_pixelFormat, false);
+}
+
+inline void ChunkedImage::priv_forEachChunk(const Rect rect, const std::function<void(std::size_t, Rect)>& chunkFunction) const
+{
+	if ((rect.size.x == 0u) || (rect.size.y == 0u) || !priv_fits(rect))
+		return;
+	const Xy firstChunk{ rect.position.x / m_chunkSize.x, rect.position.y / m_chunkSize.y };
+	const Xy lastChunk{ (rect.position.x + rect.size.x - 1u) / m_chunkSize.x, (rect.position.y + rect.size.y - 1u) / m_chunkSize.y };
+	for (std::size_t chunkY{ firstChunk.y }; chunkY <= lastChunk.y; ++chunkY)
+	{
+		for (std::size_t chunkX{ firstChunk.x }; chunkX <= lastChunk.x; ++chunkX)
+		{
+			const std::size_t chunkIndex{ (chunkY * m_numberOfChunks.x) + chunkX };
+			const Rect chunkRect{ priv_getChunkRect(chunkIndex) };
+			const Xy topLeft{ std::max(rect.position.x, chunkRect.position.x), std::max(rect.position.y, chunkRect.position.y) };
+			const Xy bottomRight{ std::min(rect.position.x + rect.size.x, chunkRect.position.x + chunkRect.size.x), std::min(rect.position.y + rect.size.y, chunkRect.position.y + chunkRect.size.y) };
+			chunkFunction(chunkIndex, { topLeft, bottomRight - topLeft });
+		}
+	}
+}
+
+inline bool ChunkedImage::priv_fits(const Rect rect) const
+{
+	return (((rect.position.x + rect.size.x) <= m_size.x) && ((rect.position.y + rect.size.y) <= m_size.y));
+}
+
+} // namespace sheetimageprocessor
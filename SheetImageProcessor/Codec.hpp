@@ -0,0 +1,70 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Sheet Image Processor (https://github.com/Hapaxia/SheetImageProcessor
+// --
+//
+// Codec
+//
+// Copyright(c) 2025-2026 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions :
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software.If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Common.hpp"
+#include "Image.hpp"
+
+#include <istream>
+#include <ostream>
+
+namespace sheetimageprocessor
+{
+
+// streaming encoders and decoders for simple lossless file formats.
+// decoding writes straight into the image's rows, in the image's current pixel format and orientation (set those before decoding).
+// images in compact pixel formats are converted a row at a time (an Indexed8 image needs its palette set before decoding)
+class Codec
+{
+public:
+	static void decodeQoi(Image& image, std::istream& stream);
+	static void decodeQoi(Image& image, const std::uint8_t* data, std::size_t size);
+	static void encodeQoi(const Image& image, std::ostream& stream);
+
+	static void decodeTga(Image& image, std::istream& stream); // supports uncompressed and RLE true-colour (24-bit and 32-bit) and greyscale (8-bit)
+	static void decodeTga(Image& image, const std::uint8_t* data, std::size_t size);
+	static void encodeTga(const Image& image, std::ostream& stream, bool useRle = true); // always 32-bit with a top-left origin
+
+private:
+	class Reader;
+	class Writer;
+
+	static void priv_decodeQoi(Image& image, Reader& reader);
+	static void priv_decodeTga(Image& image, Reader& reader);
+	static std::size_t priv_getStoredRow(const Image& image, std::size_t visualRow); // visual rows are counted from the top
+	static bool priv_isCompact(const Image& image);
+	static const std::uint8_t* priv_getRowData(const Image& image, std::size_t storedRow, Image& rowImage); // a compact image's row is converted into rowImage (in rowImage's format)
+};
+
+} // namespace sheetimageprocessor
+#include "Codec.inl"
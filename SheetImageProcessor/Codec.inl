@@ -0,0 +1,522 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Sheet Image Processor (https://github.com/Hapaxia/SheetImageProcessor
+// --
+//
+// Codec
+//
+// Copyright(c) 2025-2026 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions :
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software.If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "Codec.hpp"
+
+namespace sheetimageprocessor
+{
+
+// reads from either a stream (through a buffer) or a span of memory
+class Codec::Reader
+{
+public:
+	Reader(std::istream& stream)
+		: m_stream{ &stream }
+		, m_buffer(4096u)
+		, m_data{ nullptr }
+		, m_size{ 0u }
+		, m_position{ 0u }
+	{
+	}
+	Reader(const std::uint8_t* data, const std::size_t size)
+		: m_stream{ nullptr }
+		, m_buffer{}
+		, m_data{ data }
+		, m_size{ size }
+		, m_position{ 0u }
+	{
+	}
+
+	std::uint8_t readByte()
+	{
+		if (m_position == m_size)
+			priv_refill();
+		return m_data[m_position++];
+	}
+	void read(std::uint8_t* destination, std::size_t size)
+	{
+		while (size > 0u)
+		{
+			if (m_position == m_size)
+				priv_refill();
+			const std::size_t amount{ std::min(size, m_size - m_position) };
+			std::memcpy(destination, m_data + m_position, amount);
+			m_position += amount;
+			destination += amount;
+			size -= amount;
+		}
+	}
+	void skip(std::size_t size)
+	{
+		while (size > 0u)
+		{
+			if (m_position == m_size)
+				priv_refill();
+			const std::size_t amount{ std::min(size, m_size - m_position) };
+			m_position += amount;
+			size -= amount;
+		}
+	}
+
+private:
+	std::istream* m_stream;
+	std::vector<std::uint8_t> m_buffer;
+	const std::uint8_t* m_data;
+	std::size_t m_size;
+	std::size_t m_position;
+
+	void priv_refill()
+	{
+		if (m_stream != nullptr)
+		{
+			m_stream->read(reinterpret_cast<char*>(m_buffer.data()), static_cast<std::streamsize>(m_buffer.size()));
+			m_data = m_buffer.data();
+			m_size = static_cast<std::size_t>(m_stream->gcount());
+			m_position = 0u;
+		}
+		if (m_position == m_size)
+			throw Exception("Cannot decode: unexpected end of data.");
+	}
+};
+
+// writes to a stream through a buffer. flush() must be called at the end
+class Codec::Writer
+{
+public:
+	Writer(std::ostream& stream)
+		: m_stream{ stream }
+		, m_buffer{}
+	{
+		m_buffer.reserve(65536u);
+	}
+
+	void writeByte(const std::uint8_t value)
+	{
+		if (m_buffer.size() == m_buffer.capacity())
+			flush();
+		m_buffer.push_back(value);
+	}
+	void write(const std::uint8_t* source, const std::size_t size)
+	{
+		if ((m_buffer.size() + size) > m_buffer.capacity())
+			flush();
+		if (size > m_buffer.capacity())
+			m_stream.write(reinterpret_cast<const char*>(source), static_cast<std::streamsize>(size));
+		else
+			m_buffer.insert(m_buffer.end(), source, source + size);
+	}
+	void flush()
+	{
+		m_stream.write(reinterpret_cast<const char*>(m_buffer.data()), static_cast<std::streamsize>(m_buffer.size()));
+		m_buffer.clear();
+		if (!m_stream)
+			throw Exception("Cannot encode: failed to write to stream.");
+	}
+
+private:
+	std::ostream& m_stream;
+	std::vector<std::uint8_t> m_buffer;
+};
+
+inline void Codec::decodeQoi(Image& image, std::istream& stream)
+{
+	Reader reader{ stream };
+	priv_decodeQoi(image, reader);
+}
+
+inline void Codec::decodeQoi(Image& image, const std::uint8_t* data, const std::size_t size)
+{
+	Reader reader{ data, size };
+	priv_decodeQoi(image, reader);
+}
+
+inline void Codec::encodeQoi(const Image& image, std::ostream& stream)
+{
+	const Xy size{ image.getSize() };
+	Image rowImage{};
+	const bool isRgba{ priv_isCompact(image) || (image.getPixelFormat() == Image::PixelFormat::RGBA) };
+	const std::size_t offsetR{ isRgba ? 0u : 2u };
+	const std::size_t offsetB{ isRgba ? 2u : 0u };
+
+	Writer writer{ stream };
+	const std::array<std::uint8_t, 14u> header{
+		'q', 'o', 'i', 'f',
+		static_cast<std::uint8_t>(size.x >> 24u), static_cast<std::uint8_t>(size.x >> 16u), static_cast<std::uint8_t>(size.x >> 8u), static_cast<std::uint8_t>(size.x),
+		static_cast<std::uint8_t>(size.y >> 24u), static_cast<std::uint8_t>(size.y >> 16u), static_cast<std::uint8_t>(size.y >> 8u), static_cast<std::uint8_t>(size.y),
+		4u, 0u };
+	writer.write(header.data(), header.size());
+
+	std::array<Pixel, 64u> index{};
+	Pixel previous{ 0u, 0u, 0u, 255u };
+	std::size_t run{ 0u };
+	const std::size_t numberOfPixels{ size.x * size.y };
+	std::size_t pixelCount{ 0u };
+	for (std::size_t y{ 0u }; y < size.y; ++y)
+	{
+		const std::uint8_t* row{ priv_getRowData(image, priv_getStoredRow(image, y), rowImage) };
+		for (std::size_t x{ 0u }; x < size.x; ++x)
+		{
+			const std::uint8_t* data{ row + (x * 4u) };
+			const Pixel pixel{ data[offsetR], data[1u], data[offsetB], data[3u] };
+			++pixelCount;
+
+			if (pixel == previous)
+			{
+				++run;
+				if ((run == 62u) || (pixelCount == numberOfPixels))
+				{
+					writer.writeByte(static_cast<std::uint8_t>(0xC0u | (run - 1u)));
+					run = 0u;
+				}
+				continue;
+			}
+			if (run > 0u)
+			{
+				writer.writeByte(static_cast<std::uint8_t>(0xC0u | (run - 1u)));
+				run = 0u;
+			}
+
+			const std::size_t hash{ ((pixel.r * 3u) + (pixel.g * 5u) + (pixel.b * 7u) + (pixel.a * 11u)) % 64u };
+			if (index[hash] == pixel)
+				writer.writeByte(static_cast<std::uint8_t>(hash));
+			else
+			{
+				index[hash] = pixel;
+				if (pixel.a == previous.a)
+				{
+					const int differenceR{ static_cast<std::int8_t>(pixel.r - previous.r) };
+					const int differenceG{ static_cast<std::int8_t>(pixel.g - previous.g) };
+					const int differenceB{ static_cast<std::int8_t>(pixel.b - previous.b) };
+					const int differenceGR{ differenceR - differenceG };
+					const int differenceGB{ differenceB - differenceG };
+					if ((differenceR >= -2) && (differenceR <= 1) && (differenceG >= -2) && (differenceG <= 1) && (differenceB >= -2) && (differenceB <= 1))
+						writer.writeByte(static_cast<std::uint8_t>(0x40 | ((differenceR + 2) << 4) | ((differenceG + 2) << 2) | (differenceB + 2)));
+					else if ((differenceGR >= -8) && (differenceGR <= 7) && (differenceG >= -32) && (differenceG <= 31) && (differenceGB >= -8) && (differenceGB <= 7))
+					{
+						writer.writeByte(static_cast<std::uint8_t>(0x80 | (differenceG + 32)));
+						writer.writeByte(static_cast<std::uint8_t>(((differenceGR + 8) << 4) | (differenceGB + 8)));
+					}
+					else
+					{
+						const std::array<std::uint8_t, 4u> chunk{ 0xFEu, pixel.r, pixel.g, pixel.b };
+						writer.write(chunk.data(), chunk.size());
+					}
+				}
+				else
+				{
+					const std::array<std::uint8_t, 5u> chunk{ 0xFFu, pixel.r, pixel.g, pixel.b, pixel.a };
+					writer.write(chunk.data(), chunk.size());
+				}
+			}
+			previous = pixel;
+		}
+	}
+
+	const std::array<std::uint8_t, 8u> endMarker{ 0u, 0u, 0u, 0u, 0u, 0u, 0u, 1u };
+	writer.write(endMarker.data(), endMarker.size());
+	writer.flush();
+}
+
+inline void Codec::decodeTga(Image& image, std::istream& stream)
+{
+	Reader reader{ stream };
+	priv_decodeTga(image, reader);
+}
+
+inline void Codec::decodeTga(Image& image, const std::uint8_t* data, const std::size_t size)
+{
+	Reader reader{ data, size };
+	priv_decodeTga(image, reader);
+}
+
+inline void Codec::encodeTga(const Image& image, std::ostream& stream, const bool useRle)
+{
+	const Xy size{ image.getSize() };
+	if ((size.x > 0xFFFFu) || (size.y > 0xFFFFu))
+		throw Exception("Cannot encode TGA: image is too large.");
+	Image rowImage{};
+	rowImage.setPixelFormat(Image::PixelFormat::BGRA);
+	const bool isBgra{ priv_isCompact(image) || (image.getPixelFormat() == Image::PixelFormat::BGRA) };
+
+	Writer writer{ stream };
+	const std::array<std::uint8_t, 18u> header{
+		0u, 0u, static_cast<std::uint8_t>(useRle ? 10u : 2u),
+		0u, 0u, 0u, 0u, 0u,
+		0u, 0u, 0u, 0u,
+		static_cast<std::uint8_t>(size.x), static_cast<std::uint8_t>(size.x >> 8u),
+		static_cast<std::uint8_t>(size.y), static_cast<std::uint8_t>(size.y >> 8u),
+		32u, 0x28u }; // 8 bits of alpha, top-left origin
+	writer.write(header.data(), header.size());
+
+	std::vector<std::uint8_t> bgraRow(size.x * 4u);
+	for (std::size_t y{ 0u }; y < size.y; ++y)
+	{
+		const std::uint8_t* row{ priv_getRowData(image, priv_getStoredRow(image, y), rowImage) };
+		if (!isBgra)
+		{
+			for (std::size_t x{ 0u }; x < size.x; ++x)
+			{
+				const std::size_t dataIndex{ x * 4u };
+				bgraRow[dataIndex + 0u] = row[dataIndex + 2u];
+				bgraRow[dataIndex + 1u] = row[dataIndex + 1u];
+				bgraRow[dataIndex + 2u] = row[dataIndex + 0u];
+				bgraRow[dataIndex + 3u] = row[dataIndex + 3u];
+			}
+			row = bgraRow.data();
+		}
+
+		if (!useRle)
+		{
+			writer.write(row, size.x * 4u);
+			continue;
+		}
+
+		// packets do not cross rows. a run packet is used for two or more equal pixels
+		auto isSamePixel = [row](const std::size_t a, const std::size_t b) { return (std::memcmp(row + (a * 4u), row + (b * 4u), 4u) == 0); };
+		std::size_t x{ 0u };
+		while (x < size.x)
+		{
+			std::size_t length{ 1u };
+			while (((x + length) < size.x) && (length < 128u) && isSamePixel(x, x + length))
+				++length;
+			if (length > 1u)
+			{
+				writer.writeByte(static_cast<std::uint8_t>(0x80u | (length - 1u)));
+				writer.write(row + (x * 4u), 4u);
+			}
+			else
+			{
+				while (((x + length) < size.x) && (length < 128u) && !(((x + length + 1u) < size.x) && isSamePixel(x + length, x + length + 1u)))
+					++length;
+				writer.writeByte(static_cast<std::uint8_t>(length - 1u));
+				writer.write(row + (x * 4u), length * 4u);
+			}
+			x += length;
+		}
+	}
+	writer.flush();
+}
+
+inline void Codec::priv_decodeQoi(Image& image, Reader& reader)
+{
+	std::array<std::uint8_t, 14u> header{};
+	reader.read(header.data(), header.size());
+	if ((header[0u] != 'q') || (header[1u] != 'o') || (header[2u] != 'i') || (header[3u] != 'f'))
+		throw Exception("Cannot decode QOI: invalid header.");
+	const Xy size{
+		(static_cast<std::size_t>(header[4u]) << 24u) | (static_cast<std::size_t>(header[5u]) << 16u) | (static_cast<std::size_t>(header[6u]) << 8u) | header[7u],
+		(static_cast<std::size_t>(header[8u]) << 24u) | (static_cast<std::size_t>(header[9u]) << 16u) | (static_cast<std::size_t>(header[10u]) << 8u) | header[11u] };
+	if ((header[12u] != 3u) && (header[12u] != 4u))
+		throw Exception("Cannot decode QOI: invalid number of channels.");
+	// (the size is read from the data so it is checked before anything is allocated for it)
+	constexpr std::size_t maxNumberOfPixels{ 400000000u }; // limit given by the QOI specification
+	if ((size.x != 0u) && (size.y > (maxNumberOfPixels / size.x)))
+		throw Exception("Cannot decode QOI: image is too large.");
+
+	image.setSize(size, false);
+	const bool isCompact{ priv_isCompact(image) };
+	Image rowImage{};
+	if (isCompact)
+		rowImage.setSize({ size.x, 1u }, false);
+	const bool isRgba{ isCompact || (image.getPixelFormat() == Image::PixelFormat::RGBA) };
+	const std::size_t offsetR{ isRgba ? 0u : 2u };
+	const std::size_t offsetB{ isRgba ? 2u : 0u };
+
+	std::array<Pixel, 64u> index{};
+	Pixel pixel{ 0u, 0u, 0u, 255u };
+	std::size_t run{ 0u };
+	for (std::size_t y{ 0u }; y < size.y; ++y)
+	{
+		const std::size_t storedRow{ priv_getStoredRow(image, y) };
+		std::uint8_t* row{ isCompact ? rowImage.accessRowData(0u) : image.accessRowData(storedRow) };
+		for (std::size_t x{ 0u }; x < size.x; ++x)
+		{
+			if (run > 0u)
+				--run;
+			else
+			{
+				const std::uint8_t op{ reader.readByte() };
+				if (op == 0xFEu)
+				{
+					pixel.r = reader.readByte();
+					pixel.g = reader.readByte();
+					pixel.b = reader.readByte();
+				}
+				else if (op == 0xFFu)
+				{
+					pixel.r = reader.readByte();
+					pixel.g = reader.readByte();
+					pixel.b = reader.readByte();
+					pixel.a = reader.readByte();
+				}
+				else if ((op & 0xC0u) == 0x00u)
+					pixel = index[op];
+				else if ((op & 0xC0u) == 0x40u)
+				{
+					pixel.r = static_cast<std::uint8_t>(pixel.r + ((op >> 4u) & 0x03u) - 2u);
+					pixel.g = static_cast<std::uint8_t>(pixel.g + ((op >> 2u) & 0x03u) - 2u);
+					pixel.b = static_cast<std::uint8_t>(pixel.b + (op & 0x03u) - 2u);
+				}
+				else if ((op & 0xC0u) == 0x80u)
+				{
+					const std::uint8_t second{ reader.readByte() };
+					const int differenceG{ static_cast<int>(op & 0x3Fu) - 32 };
+					pixel.r = static_cast<std::uint8_t>(pixel.r + differenceG - 8 + ((second >> 4u) & 0x0Fu));
+					pixel.g = static_cast<std::uint8_t>(pixel.g + differenceG);
+					pixel.b = static_cast<std::uint8_t>(pixel.b + differenceG - 8 + (second & 0x0Fu));
+				}
+				else
+					run = op & 0x3Fu;
+				index[((pixel.r * 3u) + (pixel.g * 5u) + (pixel.b * 7u) + (pixel.a * 11u)) % 64u] = pixel;
+			}
+
+			std::uint8_t* data{ row + (x * 4u) };
+			data[offsetR] = pixel.r;
+			data[1u] = pixel.g;
+			data[offsetB] = pixel.b;
+			data[3u] = pixel.a;
+		}
+		if (isCompact)
+			image.copy({ 0u, storedRow }, rowImage, { { 0u, 0u }, { size.x, 1u } });
+	}
+}
+
+inline void Codec::priv_decodeTga(Image& image, Reader& reader)
+{
+	std::array<std::uint8_t, 18u> header{};
+	reader.read(header.data(), header.size());
+	const std::size_t idLength{ header[0u] };
+	const std::size_t colourMapType{ header[1u] };
+	const std::size_t imageType{ header[2u] };
+	const std::size_t colourMapLength{ static_cast<std::size_t>(header[5u]) | (static_cast<std::size_t>(header[6u]) << 8u) };
+	const std::size_t colourMapEntrySize{ header[7u] };
+	const Xy size{ static_cast<std::size_t>(header[12u]) | (static_cast<std::size_t>(header[13u]) << 8u), static_cast<std::size_t>(header[14u]) | (static_cast<std::size_t>(header[15u]) << 8u) };
+	const std::size_t depth{ header[16u] };
+	const bool isTopOrigin{ (header[17u] & 0x20u) != 0u };
+	const bool isRightToLeft{ (header[17u] & 0x10u) != 0u };
+
+	const bool isRle{ (imageType & 8u) != 0u };
+	const std::size_t baseType{ imageType & 7u };
+	const bool isGreyscale{ baseType == 3u };
+	if (!(((baseType == 2u) && ((depth == 24u) || (depth == 32u))) || (isGreyscale && (depth == 8u))))
+		throw Exception("Cannot decode TGA: unsupported image type.");
+
+	reader.skip(idLength);
+	if (colourMapType == 1u)
+		reader.skip(colourMapLength * ((colourMapEntrySize + 7u) / 8u));
+
+	image.setSize(size, false);
+	const bool isCompact{ priv_isCompact(image) };
+	Image rowImage{};
+	if (isCompact)
+		rowImage.setSize({ size.x, 1u }, false);
+	const bool isBgra{ !isCompact && (image.getPixelFormat() == Image::PixelFormat::BGRA) };
+	const std::size_t offsetR{ isBgra ? 2u : 0u };
+	const std::size_t offsetB{ isBgra ? 0u : 2u };
+	const std::size_t bytesPerPixel{ depth / 8u };
+
+	std::array<std::uint8_t, 4u> filePixel{ 0u, 0u, 0u, 255u };
+	auto readFilePixel = [&]()
+	{
+		reader.read(filePixel.data(), bytesPerPixel);
+		if (isGreyscale)
+		{
+			filePixel[1u] = filePixel[0u];
+			filePixel[2u] = filePixel[0u];
+		}
+	};
+
+	std::size_t packetRemaining{ 0u };
+	bool isRunPacket{ false };
+	for (std::size_t fileY{ 0u }; fileY < size.y; ++fileY)
+	{
+		const std::size_t storedRow{ priv_getStoredRow(image, isTopOrigin ? fileY : (size.y - fileY - 1u)) };
+		std::uint8_t* row{ isCompact ? rowImage.accessRowData(0u) : image.accessRowData(storedRow) };
+
+		// 32-bit uncompressed rows are already in BGRA
+		if (!isRle && isBgra && (depth == 32u) && !isRightToLeft)
+		{
+			reader.read(row, size.x * 4u);
+			continue;
+		}
+
+		for (std::size_t fileX{ 0u }; fileX < size.x; ++fileX)
+		{
+			if (isRle)
+			{
+				if (packetRemaining == 0u)
+				{
+					const std::uint8_t packetHeader{ reader.readByte() };
+					isRunPacket = ((packetHeader & 0x80u) != 0u);
+					packetRemaining = (packetHeader & 0x7Fu) + 1u;
+					readFilePixel();
+				}
+				else if (!isRunPacket)
+					readFilePixel();
+				--packetRemaining;
+			}
+			else
+				readFilePixel();
+
+			std::uint8_t* data{ row + ((isRightToLeft ? (size.x - fileX - 1u) : fileX) * 4u) };
+			data[offsetB] = filePixel[0u];
+			data[1u] = filePixel[1u];
+			data[offsetR] = filePixel[2u];
+			data[3u] = filePixel[3u];
+		}
+		if (isCompact)
+			image.copy({ 0u, storedRow }, rowImage, { { 0u, 0u }, { size.x, 1u } });
+	}
+}
+
+inline std::size_t Codec::priv_getStoredRow(const Image& image, const std::size_t visualRow)
+{
+	return image.getIsTopDown() ? visualRow : (image.getSize().y - visualRow - 1u);
+}
+
+inline bool Codec::priv_isCompact(const Image& image)
+{
+	return (image.getNumberOfValuesPerPixel() != 4u);
+}
+
+inline const std::uint8_t* Codec::priv_getRowData(const Image& image, const std::size_t storedRow, Image& rowImage)
+{
+	if (!priv_isCompact(image))
+		return image.getRowData(storedRow);
+	const std::size_t width{ image.getSize().x };
+	rowImage.setSize({ width, 1u }, false);
+	rowImage.copy({ 0u, 0u }, image, { { 0u, storedRow }, { width, 1u } });
+	return rowImage.getRowData(0u);
+}
+
+} // namespace sheetimageprocessor
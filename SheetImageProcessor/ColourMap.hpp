@@ -0,0 +1,68 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Sheet Image Processor (https://github.com/Hapaxia/SheetImageProcessor
+// --
+//
+// ColourMap
+//
+// Copyright(c) 2025-2026 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions :
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software.If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Common.hpp"
+#include "Pixel.hpp"
+
+namespace sheetimageprocessor
+{
+
+// a hash map from packed 32-bit pixels, using open addressing with linear probing. grows to keep at most half of its slots used
+template <class T>
+class ColourMap
+{
+public:
+	ColourMap(std::size_t expectedSize = 0u);
+
+	T& operator[](std::uint32_t key); // inserts a value-initialised T if key is not in the map
+	const T* find(std::uint32_t key) const; // nullptr if key is not in the map
+	std::size_t getSize() const;
+	void clear();
+	template <class Function>
+	void forEach(Function function) const; // calls function(key, value) for each entry (in no particular order)
+
+	static std::uint32_t getKey(const Pixel& pixel); // the packed pixel (see Pixel::getPacked)
+
+private:
+	std::vector<std::uint32_t> m_keys;
+	std::vector<T> m_values;
+	std::vector<std::uint8_t> m_isUsed;
+	std::size_t m_size;
+
+	std::size_t priv_getSlot(std::uint32_t key) const; // where key is or would be inserted
+	void priv_grow(std::size_t capacity);
+};
+
+} // namespace sheetimageprocessor
+#include "ColourMap.inl"
@@ -0,0 +1,141 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Sheet Image Processor (https://github.com/Hapaxia/SheetImageProcessor
+// --
+//
+// ColourMap
+//
+// Copyright(c) 2025-2026 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions :
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software.If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "ColourMap.hpp"
+
+#include <algorithm>
+
+namespace sheetimageprocessor
+{
+
+template <class T>
+inline ColourMap<T>::ColourMap(const std::size_t expectedSize)
+	: m_keys()
+	, m_values()
+	, m_isUsed()
+	, m_size{ 0u }
+{
+	std::size_t capacity{ 16u };
+	while (capacity < (expectedSize * 2u))
+		capacity *= 2u;
+	priv_grow(capacity);
+}
+
+template <class T>
+inline T& ColourMap<T>::operator[](const std::uint32_t key)
+{
+	std::size_t slot{ priv_getSlot(key) };
+	if (m_isUsed[slot] == 0u)
+	{
+		if (((m_size + 1u) * 2u) > m_keys.size())
+		{
+			priv_grow(m_keys.size() * 2u);
+			slot = priv_getSlot(key);
+		}
+		m_keys[slot] = key;
+		m_values[slot] = T{};
+		m_isUsed[slot] = 1u;
+		++m_size;
+	}
+	return m_values[slot];
+}
+
+template <class T>
+inline const T* ColourMap<T>::find(const std::uint32_t key) const
+{
+	const std::size_t slot{ priv_getSlot(key) };
+	return (m_isUsed[slot] != 0u) ? &m_values[slot] : nullptr;
+}
+
+template <class T>
+inline std::size_t ColourMap<T>::getSize() const
+{
+	return m_size;
+}
+
+template <class T>
+inline void ColourMap<T>::clear()
+{
+	std::fill(m_isUsed.begin(), m_isUsed.end(), std::uint8_t{ 0u });
+	m_size = 0u;
+}
+
+template <class T>
+template <class Function>
+inline void ColourMap<T>::forEach(Function function) const
+{
+	for (std::size_t slot{ 0u }; slot < m_keys.size(); ++slot)
+	{
+		if (m_isUsed[slot] != 0u)
+			function(m_keys[slot], m_values[slot]);
+	}
+}
+
+template <class T>
+inline std::uint32_t ColourMap<T>::getKey(const Pixel& pixel)
+{
+	return pixel.getPacked();
+}
+
+template <class T>
+inline std::size_t ColourMap<T>::priv_getSlot(const std::uint32_t key) const
+{
+	// Fibonacci hashing spreads nearby colours across the table. the capacity is a power of two
+	const std::size_t mask{ m_keys.size() - 1u };
+	std::size_t slot{ static_cast<std::size_t>((static_cast<std::uint64_t>(key) * 0x9E3779B97F4A7C15u) >> 32u) & mask };
+	while ((m_isUsed[slot] != 0u) && (m_keys[slot] != key))
+		slot = (slot + 1u) & mask;
+	return slot;
+}
+
+template <class T>
+inline void ColourMap<T>::priv_grow(const std::size_t capacity)
+{
+	std::vector<std::uint32_t> keys(capacity);
+	std::vector<T> values(capacity);
+	std::vector<std::uint8_t> isUsed(capacity, 0u);
+	m_keys.swap(keys);
+	m_values.swap(values);
+	m_isUsed.swap(isUsed);
+	for (std::size_t slot{ 0u }; slot < keys.size(); ++slot)
+	{
+		if (isUsed[slot] == 0u)
+			continue;
+		const std::size_t newSlot{ priv_getSlot(keys[slot]) };
+		m_keys[newSlot] = keys[slot];
+		m_values[newSlot] = std::move(values[slot]);
+		m_isUsed[newSlot] = 1u;
+	}
+}
+
+} // namespace sheetimageprocessor
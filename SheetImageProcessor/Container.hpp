@@ -0,0 +1,70 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Sheet Image Processor (https://github.com/Hapaxia/SheetImageProcessor
+// --
+//
+// Container
+//
+// Copyright(c) 2025-2026 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions :
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software.If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Common.hpp"
+#include "Image.hpp"
+#include "Atlas.hpp"
+
+namespace sheetimageprocessor
+{
+
+// versioned binary file holding an image (with its format, orientation and palette) and an atlas.
+// pixel rows are stored 64-byte aligned so that a loaded image can view the memory-mapped file directly
+class Container
+{
+public:
+	static constexpr std::uint32_t version{ 2u }; // version 2 adds compact pixel formats and the palette
+
+	static void save(const std::string& filename, const Image& image, const Atlas& atlas = Atlas{});
+	static void load(const std::string& filename, Image& image, Atlas& atlas); // image becomes a read-only view of the mapped file (copied only when edited). the file stays mapped while any image views it
+
+private:
+	class MappedFile;
+
+	static constexpr std::size_t m_headerSize{ 128u };
+	static constexpr std::size_t m_tileSize{ 88u };
+	static constexpr std::size_t m_paletteEntrySize{ 4u };
+	static constexpr std::size_t m_dataAlignment{ 64u };
+
+	static void priv_writeU32(std::uint8_t* destination, const std::uint32_t value);
+	static void priv_writeU64(std::uint8_t* destination, const std::uint64_t value);
+	static std::uint32_t priv_readU32(const std::uint8_t* source);
+	static std::uint64_t priv_readU64(const std::uint8_t* source);
+	static bool priv_multiply(const std::size_t a, const std::size_t b, std::size_t& product); // returns false (leaving product unchanged) if the product would overflow
+	static bool priv_isWithinFile(const std::size_t offset, const std::size_t size, const std::size_t fileSize);
+	static std::size_t priv_alignUp(const std::size_t value, const std::size_t alignment);
+};
+
+} // namespace sheetimageprocessor
+#include "Container.inl"
@@ -0,0 +1,357 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Sheet Image Processor (https://github.com/Hapaxia/SheetImageProcessor
+// --
+//
+// Container
+//
+// Copyright(c) 2025-2026 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions :
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software.If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "Container.hpp"
+
+#include <fstream>
+#include <limits>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif // WIN32_LEAN_AND_MEAN
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif // NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // _WIN32
+
+namespace sheetimageprocessor
+{
+
+// file layout (all values little-endian):
+//   header (128 bytes):
+//     magic "SIPC", version (u32), header size (u32), pixel format (u32), is top-down (u32), values per pixel (u32),
+//     width, height, row stride, data offset, data size, number of tiles, tile table offset, atlas max size x, atlas max size y (u64 each),
+//     number of palette entries (u64, at 96), palette offset (u64, at 104). the rest of the header is zero
+//   tile table (88 bytes per tile, at tile table offset):
+//     rect position x/y, rect size x/y, offset x/y, anchor x/y, id, category, flags (u64 each; flags: bit 0 rotated, bit 1 flipped x, bit 2 flipped y)
+//   palette (4 bytes per entry, at palette offset, directly after the tile table): r, g, b, a (u8 each). up to 256 entries, used by Indexed8
+//   pixel data: at data offset (a multiple of 64), each row padded to row stride (a multiple of 64)
+// version 1 has no palette: its pixel formats are only RGBA and BGRA and the palette fields are zero (read as no palette)
+
+// read-only memory mapping of a whole file. unmapped when destroyed
+class Container::MappedFile
+{
+public:
+	MappedFile(const std::string& filename)
+	{
+#ifdef _WIN32
+		m_file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (m_file == INVALID_HANDLE_VALUE)
+			throw Exception("Cannot open container file: " + filename);
+		LARGE_INTEGER fileSize{};
+		GetFileSizeEx(m_file, &fileSize);
+		m_size = static_cast<std::size_t>(fileSize.QuadPart);
+		if (m_size > 0u)
+		{
+			m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0u, 0u, nullptr);
+			if (m_mapping != nullptr)
+				m_data = static_cast<const std::uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0u, 0u, 0u));
+			if (m_data == nullptr)
+			{
+				close();
+				throw Exception("Cannot map container file: " + filename);
+			}
+		}
+#else
+		m_file = ::open(filename.c_str(), O_RDONLY);
+		if (m_file < 0)
+			throw Exception("Cannot open container file: " + filename);
+		struct stat fileStatus{};
+		if (::fstat(m_file, &fileStatus) != 0)
+		{
+			close();
+			throw Exception("Cannot read container file: " + filename);
+		}
+		m_size = static_cast<std::size_t>(fileStatus.st_size);
+		if (m_size > 0u)
+		{
+			void* mapping{ ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_file, 0) };
+			if (mapping == MAP_FAILED)
+			{
+				close();
+				throw Exception("Cannot map container file: " + filename);
+			}
+			m_data = static_cast<const std::uint8_t*>(mapping);
+		}
+#endif // _WIN32
+	}
+	~MappedFile()
+	{
+		close();
+	}
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	const std::uint8_t* getData() const
+	{
+		return m_data;
+	}
+	std::size_t getSize() const
+	{
+		return m_size;
+	}
+
+private:
+	const std::uint8_t* m_data{ nullptr };
+	std::size_t m_size{ 0u };
+#ifdef _WIN32
+	HANDLE m_file{ INVALID_HANDLE_VALUE };
+	HANDLE m_mapping{ nullptr };
+#else
+	int m_file{ -1 };
+#endif // _WIN32
+
+	void close()
+	{
+#ifdef _WIN32
+		if (m_data != nullptr)
+			UnmapViewOfFile(m_data);
+		if (m_mapping != nullptr)
+			CloseHandle(m_mapping);
+		if (m_file != INVALID_HANDLE_VALUE)
+			CloseHandle(m_file);
+		m_mapping = nullptr;
+		m_file = INVALID_HANDLE_VALUE;
+#else
+		if (m_data != nullptr)
+			::munmap(const_cast<std::uint8_t*>(m_data), m_size);
+		if (m_file >= 0)
+			::close(m_file);
+		m_file = -1;
+#endif // _WIN32
+		m_data = nullptr;
+	}
+};
+
+
+inline void Container::save(const std::string& filename, const Image& image, const Atlas& atlas)
+{
+	const Xy size{ image.getSize() };
+	const std::size_t valuesPerPixel{ image.getNumberOfValuesPerPixel() };
+	const std::size_t rowSize{ size.x * valuesPerPixel };
+	const std::size_t rowStride{ priv_alignUp(rowSize, m_dataAlignment) };
+	const std::vector<Atlas::Tile>& tiles{ atlas.constAccess() };
+	const std::size_t numberOfTiles{ tiles.size() };
+	const std::vector<Pixel>& palette{ image.getPalette() };
+	const std::size_t tileTableOffset{ m_headerSize };
+	const std::size_t paletteOffset{ tileTableOffset + (numberOfTiles * m_tileSize) };
+	const std::size_t dataOffset{ priv_alignUp(paletteOffset + (palette.size() * m_paletteEntrySize), m_dataAlignment) };
+	const std::size_t dataSize{ rowStride * size.y };
+
+	// header and tile table
+	std::vector<std::uint8_t> table(dataOffset, 0u);
+	std::uint8_t* header{ table.data() };
+	header[0u] = 'S';
+	header[1u] = 'I';
+	header[2u] = 'P';
+	header[3u] = 'C';
+	priv_writeU32(header + 4u, version);
+	priv_writeU32(header + 8u, static_cast<std::uint32_t>(m_headerSize));
+	priv_writeU32(header + 12u, static_cast<std::uint32_t>(image.getPixelFormat()));
+	priv_writeU32(header + 16u, image.getIsTopDown() ? 1u : 0u);
+	priv_writeU32(header + 20u, static_cast<std::uint32_t>(valuesPerPixel));
+	priv_writeU64(header + 24u, size.x);
+	priv_writeU64(header + 32u, size.y);
+	priv_writeU64(header + 40u, rowStride);
+	priv_writeU64(header + 48u, dataOffset);
+	priv_writeU64(header + 56u, dataSize);
+	priv_writeU64(header + 64u, numberOfTiles);
+	priv_writeU64(header + 72u, tileTableOffset);
+	priv_writeU64(header + 80u, atlas.getMaxSize().x);
+	priv_writeU64(header + 88u, atlas.getMaxSize().y);
+	priv_writeU64(header + 96u, palette.size());
+	priv_writeU64(header + 104u, paletteOffset);
+	for (std::size_t i{ 0u }; i < numberOfTiles; ++i)
+	{
+		const Atlas::Tile& tile{ tiles[i] };
+		std::uint8_t* record{ table.data() + tileTableOffset + (i * m_tileSize) };
+		const std::uint64_t flags{ (tile.isRotated ? 1u : 0u) | (tile.isFlippedX ? 2u : 0u) | (tile.isFlippedY ? 4u : 0u) };
+		const std::array<std::uint64_t, 11u> values{ tile.rect.position.x, tile.rect.position.y, tile.rect.size.x, tile.rect.size.y, tile.offset.x, tile.offset.y, tile.anchor.x, tile.anchor.y, tile.id, tile.category, flags };
+		for (std::size_t v{ 0u }; v < values.size(); ++v)
+			priv_writeU64(record + (v * 8u), values[v]);
+	}
+	for (std::size_t i{ 0u }; i < palette.size(); ++i)
+	{
+		std::uint8_t* entry{ table.data() + paletteOffset + (i * m_paletteEntrySize) };
+		entry[0u] = palette[i].r;
+		entry[1u] = palette[i].g;
+		entry[2u] = palette[i].b;
+		entry[3u] = palette[i].a;
+	}
+
+	std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+	if (!file)
+		throw Exception("Cannot create container file: " + filename);
+	file.write(reinterpret_cast<const char*>(table.data()), static_cast<std::streamsize>(table.size()));
+
+	// pixel data, a row at a time
+	if (dataSize > 0u)
+	{
+		const std::uint8_t* data{ image.getData() };
+		const std::size_t imageRowStride{ image.getRowStride() };
+		std::vector<std::uint8_t> row(rowStride, 0u);
+		for (std::size_t y{ 0u }; y < size.y; ++y)
+		{
+			std::memcpy(row.data(), data + (y * imageRowStride), rowSize);
+			file.write(reinterpret_cast<const char*>(row.data()), static_cast<std::streamsize>(rowStride));
+		}
+	}
+	if (!file)
+		throw Exception("Cannot write container file: " + filename);
+}
+
+inline void Container::load(const std::string& filename, Image& image, Atlas& atlas)
+{
+	auto mappedFile{ std::make_shared<const MappedFile>(filename) };
+	const std::uint8_t* fileData{ mappedFile->getData() };
+	const std::size_t fileSize{ mappedFile->getSize() };
+
+	if ((fileSize < m_headerSize) || (fileData[0u] != 'S') || (fileData[1u] != 'I') || (fileData[2u] != 'P') || (fileData[3u] != 'C'))
+		throw Exception("Cannot load container: not a container file.");
+	if (priv_readU32(fileData + 4u) > version)
+		throw Exception("Cannot load container: unsupported version.");
+
+	const std::uint32_t pixelFormat{ priv_readU32(fileData + 12u) };
+	const bool isTopDown{ priv_readU32(fileData + 16u) != 0u };
+	const std::size_t valuesPerPixel{ priv_readU32(fileData + 20u) };
+	const Xy size{ priv_readU64(fileData + 24u), priv_readU64(fileData + 32u) };
+	const std::size_t rowStride{ static_cast<std::size_t>(priv_readU64(fileData + 40u)) };
+	const std::size_t dataOffset{ static_cast<std::size_t>(priv_readU64(fileData + 48u)) };
+	const std::size_t dataSize{ static_cast<std::size_t>(priv_readU64(fileData + 56u)) };
+	const std::size_t numberOfTiles{ static_cast<std::size_t>(priv_readU64(fileData + 64u)) };
+	const std::size_t tileTableOffset{ static_cast<std::size_t>(priv_readU64(fileData + 72u)) };
+	const Xy maxSize{ priv_readU64(fileData + 80u), priv_readU64(fileData + 88u) };
+	const std::size_t paletteSize{ static_cast<std::size_t>(priv_readU64(fileData + 96u)) }; // (zero in version 1)
+	const std::size_t paletteOffset{ static_cast<std::size_t>(priv_readU64(fileData + 104u)) };
+
+	if ((pixelFormat > static_cast<std::uint32_t>(Image::PixelFormat::Indexed8)) || (valuesPerPixel != Image::getNumberOfValuesPerPixel(static_cast<Image::PixelFormat>(pixelFormat))))
+		throw Exception("Cannot load container: unsupported pixel format.");
+	// (the sizes are read from the file so none of the arithmetic may overflow)
+	std::size_t rowSize{ 0u };
+	std::size_t imageDataSize{ 0u };
+	std::size_t tileTableSize{ 0u };
+	if (!priv_multiply(size.x, valuesPerPixel, rowSize) || (rowStride < rowSize) ||
+		!priv_multiply(rowStride, size.y, imageDataSize) || (dataSize < imageDataSize) ||
+		!priv_isWithinFile(dataOffset, dataSize, fileSize) ||
+		!priv_multiply(numberOfTiles, m_tileSize, tileTableSize) || !priv_isWithinFile(tileTableOffset, tileTableSize, fileSize) ||
+		(paletteSize > 256u) ||
+		!priv_isWithinFile(paletteOffset, paletteSize * m_paletteEntrySize, fileSize))
+		throw Exception("Cannot load container: file is truncated or corrupt.");
+
+	atlas.clear();
+	atlas.setMaxSize(maxSize);
+	atlas.resize(numberOfTiles);
+	for (std::size_t i{ 0u }; i < numberOfTiles; ++i)
+	{
+		const std::uint8_t* record{ fileData + tileTableOffset + (i * m_tileSize) };
+		std::array<std::uint64_t, 11u> values{};
+		for (std::size_t v{ 0u }; v < values.size(); ++v)
+			values[v] = priv_readU64(record + (v * 8u));
+		Atlas::Tile& tile{ atlas.access(i) };
+		tile.rect = { { values[0u], values[1u] }, { values[2u], values[3u] } };
+		tile.offset = { values[4u], values[5u] };
+		tile.anchor = { values[6u], values[7u] };
+		tile.id = static_cast<std::size_t>(values[8u]);
+		tile.category = static_cast<std::size_t>(values[9u]);
+		tile.isRotated = ((values[10u] & 1u) != 0u);
+		tile.isFlippedX = ((values[10u] & 2u) != 0u);
+		tile.isFlippedY = ((values[10u] & 4u) != 0u);
+	}
+
+	std::vector<Pixel> palette(paletteSize);
+	for (std::size_t i{ 0u }; i < paletteSize; ++i)
+	{
+		const std::uint8_t* entry{ fileData + paletteOffset + (i * m_paletteEntrySize) };
+		palette[i] = { entry[0u], entry[1u], entry[2u], entry[3u] };
+	}
+
+	image.setPalette(palette);
+	image.setPixelFormat(static_cast<Image::PixelFormat>(pixelFormat), false);
+	image.setIsTopDown(isTopDown, false);
+	image.setView(size, fileData + dataOffset, rowStride, mappedFile);
+}
+
+inline void Container::priv_writeU32(std::uint8_t* destination, const std::uint32_t value)
+{
+	for (std::size_t i{ 0u }; i < 4u; ++i)
+		destination[i] = static_cast<std::uint8_t>(value >> (i * 8u));
+}
+
+inline void Container::priv_writeU64(std::uint8_t* destination, const std::uint64_t value)
+{
+	for (std::size_t i{ 0u }; i < 8u; ++i)
+		destination[i] = static_cast<std::uint8_t>(value >> (i * 8u));
+}
+
+inline bool Container::priv_multiply(const std::size_t a, const std::size_t b, std::size_t& product)
+{
+	if ((a != 0u) && (b > (std::numeric_limits<std::size_t>::max() / a)))
+		return false;
+	product = a * b;
+	return true;
+}
+
+inline bool Container::priv_isWithinFile(const std::size_t offset, const std::size_t size, const std::size_t fileSize)
+{
+	return (offset <= fileSize) && (size <= (fileSize - offset));
+}
+
+inline std::uint32_t Container::priv_readU32(const std::uint8_t* source)
+{
+	std::uint32_t value{ 0u };
+	for (std::size_t i{ 0u }; i < 4u; ++i)
+		value |= static_cast<std::uint32_t>(source[i]) << (i * 8u);
+	return value;
+}
+
+inline std::uint64_t Container::priv_readU64(const std::uint8_t* source)
+{
+	std::uint64_t value{ 0u };
+	for (std::size_t i{ 0u }; i < 8u; ++i)
+		value |= static_cast<std::uint64_t>(source[i]) << (i * 8u);
+	return value;
+}
+
+inline std::size_t Container::priv_alignUp(const std::size_t value, const std::size_t alignment)
+{
+	return ((value + alignment - 1u) / alignment) * alignment;
+}
+
+} // namespace sheetimageprocessor
@@ -0,0 +1,74 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Sheet Image Processor (https://github.com/Hapaxia/SheetImageProcessor
+// --
+//
+// Filter
+//
+// Copyright(c) 2025-2026 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions :
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software.If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Common.hpp"
+#include "Image.hpp"
+#include "Atlas.hpp"
+
+namespace sheetimageprocessor
+{
+
+// separable convolution (horizontally then vertically) within a rect or within each tile of an atlas. sampling is clamped to the rect so neighbouring tiles never bleed into each other.
+// all four channels are filtered as they are: premultiply first to avoid dark fringes around transparency
+class Filter
+{
+public:
+	static void boxBlur(Image& image, std::size_t radius, Rect rect = Rect{}); // the mean of (2 x radius + 1) pixels in each direction
+	static void boxBlur(Image& image, const Atlas& atlas, std::size_t radius);
+	static void gaussianBlur(Image& image, float sigma, Rect rect = Rect{});
+	static void gaussianBlur(Image& image, const Atlas& atlas, float sigma);
+	static void sharpen(Image& image, float amount, float sigma = 1.f, Rect rect = Rect{}); // unsharp mask: adds amount x (original - Gaussian blur)
+	static void sharpen(Image& image, const Atlas& atlas, float amount, float sigma = 1.f);
+	static void convolve(Image& image, const std::vector<float>& taps, Rect rect = Rect{}); // taps are centred (there must be an odd number of them) and used in both directions
+	static void convolve(Image& image, const Atlas& atlas, const std::vector<float>& taps);
+
+	static std::vector<float> getGaussianTaps(float sigma); // normalised, reaching three sigma each side
+
+private:
+	struct Kernel
+	{
+		std::vector<float> taps{}; // unused by a box
+		std::size_t boxRadius{ 0u };
+		bool isBox{ false };
+		float sharpenAmount{ 0.f }; // 0 for no sharpening
+	};
+
+	static void priv_filter(Image& image, const std::vector<Rect>& rects, const Kernel& kernel);
+	static void priv_filterRect(Image& image, Rect rect, const Kernel& kernel, bool isParallel);
+	static void priv_filterLine(const float* source, float* destination, std::size_t length, std::size_t step, const Kernel& kernel); // step (in floats) is between pixels. all four channels are filtered
+	static std::vector<Rect> priv_getRects(const Atlas& atlas);
+};
+
+} // namespace sheetimageprocessor
+#include "Filter.inl"
@@ -0,0 +1,255 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Sheet Image Processor (https://github.com/Hapaxia/SheetImageProcessor
+// --
+//
+// Filter
+//
+// Copyright(c) 2025-2026 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions :
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software.If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "Filter.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace sheetimageprocessor
+{
+
+inline void Filter::boxBlur(Image& image, const std::size_t radius, const Rect rect)
+{
+	Kernel kernel{};
+	kernel.boxRadius = radius;
+	kernel.isBox = true;
+	priv_filter(image, { rect }, kernel);
+}
+
+inline void Filter::boxBlur(Image& image, const Atlas& atlas, const std::size_t radius)
+{
+	Kernel kernel{};
+	kernel.boxRadius = radius;
+	kernel.isBox = true;
+	priv_filter(image, priv_getRects(atlas), kernel);
+}
+
+inline void Filter::gaussianBlur(Image& image, const float sigma, const Rect rect)
+{
+	priv_filter(image, { rect }, { getGaussianTaps(sigma) });
+}
+
+inline void Filter::gaussianBlur(Image& image, const Atlas& atlas, const float sigma)
+{
+	priv_filter(image, priv_getRects(atlas), { getGaussianTaps(sigma) });
+}
+
+inline void Filter::sharpen(Image& image, const float amount, const float sigma, const Rect rect)
+{
+	Kernel kernel{ getGaussianTaps(sigma) };
+	kernel.sharpenAmount = amount;
+	priv_filter(image, { rect }, kernel);
+}
+
+inline void Filter::sharpen(Image& image, const Atlas& atlas, const float amount, const float sigma)
+{
+	Kernel kernel{ getGaussianTaps(sigma) };
+	kernel.sharpenAmount = amount;
+	priv_filter(image, priv_getRects(atlas), kernel);
+}
+
+inline void Filter::convolve(Image& image, const std::vector<float>& taps, const Rect rect)
+{
+	if ((taps.size() % 2u) == 0u)
+		throw Exception("Cannot convolve: number of taps must be odd.");
+	priv_filter(image, { rect }, { taps });
+}
+
+inline void Filter::convolve(Image& image, const Atlas& atlas, const std::vector<float>& taps)
+{
+	if ((taps.size() % 2u) == 0u)
+		throw Exception("Cannot convolve: number of taps must be odd.");
+	priv_filter(image, priv_getRects(atlas), { taps });
+}
+
+inline std::vector<float> Filter::getGaussianTaps(const float sigma)
+{
+	if (sigma <= 0.f)
+		return { 1.f };
+
+	const std::size_t radius{ static_cast<std::size_t>(std::ceil(sigma * 3.f)) };
+	std::vector<float> taps((radius * 2u) + 1u);
+	float total{ 0.f };
+	for (std::size_t i{ 0u }; i < taps.size(); ++i)
+	{
+		const float distance{ static_cast<float>(i) - static_cast<float>(radius) };
+		taps[i] = std::exp(-(distance * distance) / (2.f * sigma * sigma));
+		total += taps[i];
+	}
+	for (float& tap : taps)
+		tap /= total;
+	return taps;
+}
+
+inline void Filter::priv_filter(Image& image, const std::vector<Rect>& rects, const Kernel& kernel)
+{
+	const Xy imageSize{ image.getSize() };
+	if ((imageSize.x == 0u) || (imageSize.y == 0u))
+		return;
+	image.takeOwnership();
+
+	// a single rect is filtered with its rows (and columns) in parallel; otherwise the rects are
+	if (rects.size() == 1u)
+	{
+		priv_filterRect(image, rects[0u], kernel, true);
+		return;
+	}
+	Parallel::forEach(rects.size(), [&](const std::size_t i)
+	{
+		priv_filterRect(image, rects[i], kernel, false);
+	});
+}
+
+inline void Filter::priv_filterRect(Image& image, Rect rect, const Kernel& kernel, const bool isParallel)
+{
+	const Xy imageSize{ image.getSize() };
+	if ((rect.size.x == 0u) || (rect.size.y == 0u))
+		rect = { { 0u, 0u }, imageSize };
+	if ((rect.position.x >= imageSize.x) || (rect.position.y >= imageSize.y))
+		return;
+	rect.size.x = std::min(rect.size.x, imageSize.x - rect.position.x);
+	rect.size.y = std::min(rect.size.y, imageSize.y - rect.position.y);
+	if ((rect.size.x == 0u) || (rect.size.y == 0u))
+		return;
+
+	// work on an RGBA copy of the rect
+	Image tile{};
+	tile.setScratchPool(image.getScratchPool());
+	tile.setSize(rect.size, false);
+	tile.copy({ 0u, 0u }, image, rect);
+
+	// the tile keeps the original (for sharpening) and a single float buffer takes both passes: each line is copied into its job's own working line (which also holds a filtered column) and then filtered back into the buffer
+	const std::size_t rowLength{ rect.size.x * 4u };
+	const std::size_t columnLength{ rect.size.y * 4u };
+	std::vector<float> filtered(rowLength * rect.size.y);
+	auto forEachLine = [&](const std::size_t numberOfLines, const std::function<void(std::size_t, std::vector<float>&)>& lineFunction)
+	{
+		const std::size_t numberOfJobs{ isParallel ? std::max(std::min(Parallel::getMaxNumberOfThreads(), numberOfLines), std::size_t{ 1u }) : 1u };
+		auto filterJob = [&](const std::size_t job)
+		{
+			std::vector<float> line(std::max(rowLength, columnLength * 2u));
+			for (std::size_t i{ job }; i < numberOfLines; i += numberOfJobs)
+				lineFunction(i, line);
+		};
+		if (numberOfJobs > 1u)
+			Parallel::forEach(numberOfJobs, filterJob);
+		else
+			filterJob(0u);
+	};
+	forEachLine(rect.size.y, [&](const std::size_t y, std::vector<float>& line)
+	{
+		const std::uint8_t* row{ tile.getRowData(y) };
+		std::copy(row, row + rowLength, line.begin());
+		priv_filterLine(line.data(), filtered.data() + (y * rowLength), rect.size.x, 4u, kernel);
+	});
+	forEachLine(rect.size.x, [&](const std::size_t x, std::vector<float>& line)
+	{
+		for (std::size_t y{ 0u }; y < rect.size.y; ++y)
+			std::copy_n(filtered.data() + (y * rowLength) + (x * 4u), 4u, line.begin() + (y * 4u));
+		priv_filterLine(line.data(), line.data() + columnLength, rect.size.y, 4u, kernel);
+		for (std::size_t y{ 0u }; y < rect.size.y; ++y)
+			std::copy_n(line.data() + columnLength + (y * 4u), 4u, filtered.begin() + (y * rowLength) + (x * 4u));
+	});
+
+	for (std::size_t y{ 0u }; y < rect.size.y; ++y)
+	{
+		std::uint8_t* row{ tile.accessRowData(y) };
+		for (std::size_t i{ 0u }; i < rowLength; ++i)
+		{
+			float value{ filtered[(y * rowLength) + i] };
+			if (kernel.sharpenAmount != 0.f)
+			{
+				const float original{ static_cast<float>(row[i]) };
+				value = original + (kernel.sharpenAmount * (original - value));
+			}
+			row[i] = static_cast<std::uint8_t>(std::clamp(value, 0.f, 255.f) + 0.5f);
+		}
+	}
+	image.copy(rect.position, tile, { { 0u, 0u }, rect.size });
+}
+
+inline void Filter::priv_filterLine(const float* source, float* destination, const std::size_t length, const std::size_t step, const Kernel& kernel)
+{
+	// samples beyond either end repeat the end pixel
+	auto getIndex = [length](const std::ptrdiff_t i) { return static_cast<std::size_t>(std::clamp(i, std::ptrdiff_t{ 0 }, static_cast<std::ptrdiff_t>(length) - 1)); };
+
+	if (kernel.isBox)
+	{
+		// sliding window: one pixel enters and one leaves for each step
+		const std::ptrdiff_t radius{ static_cast<std::ptrdiff_t>(kernel.boxRadius) };
+		const float scale{ 1.f / static_cast<float>((radius * 2) + 1) };
+		for (std::size_t c{ 0u }; c < 4u; ++c)
+		{
+			float sum{ 0.f };
+			for (std::ptrdiff_t i{ -radius }; i <= radius; ++i)
+				sum += source[(getIndex(i) * step) + c];
+			for (std::size_t i{ 0u }; i < length; ++i)
+			{
+				destination[(i * step) + c] = sum * scale;
+				const std::ptrdiff_t position{ static_cast<std::ptrdiff_t>(i) };
+				sum += source[(getIndex(position + radius + 1) * step) + c] - source[(getIndex(position - radius) * step) + c];
+			}
+		}
+		return;
+	}
+
+	const std::ptrdiff_t radius{ static_cast<std::ptrdiff_t>(kernel.taps.size() / 2u) };
+	for (std::size_t i{ 0u }; i < length; ++i)
+	{
+		std::array<float, 4u> sums{};
+		for (std::ptrdiff_t t{ -radius }; t <= radius; ++t)
+		{
+			const float tap{ kernel.taps[static_cast<std::size_t>(t + radius)] };
+			const float* sample{ source + (getIndex(static_cast<std::ptrdiff_t>(i) + t) * step) };
+			for (std::size_t c{ 0u }; c < 4u; ++c)
+				sums[c] += sample[c] * tap;
+		}
+		for (std::size_t c{ 0u }; c < 4u; ++c)
+			destination[(i * step) + c] = sums[c];
+	}
+}
+
+inline std::vector<Rect> Filter::priv_getRects(const Atlas& atlas)
+{
+	std::vector<Rect> rects{};
+	rects.reserve(atlas.getSize());
+	for (const Atlas::Tile& tile : atlas.constAccess())
+	{
+		if ((tile.rect.size.x > 0u) && (tile.rect.size.y > 0u))
+			rects.push_back(tile.rect);
+	}
+	return rects;
+}
+
+} // namespace sheetimageprocessor
@@ -37,8 +37,14 @@
 #include "Xy.hpp"
 #include "Rect.hpp"
 #include "Atlas.hpp"
+#include "Parallel.hpp"
+#include "Allocator.hpp"
+#include "ScratchPool.hpp"
+#include "ColourMap.hpp"
+#include "Selection.hpp"
 
 #include <functional>
+#include <memory>
 
 namespace sheetimageprocessor
 {
@@ -46,16 +52,36 @@ namespace sheetimageprocessor
 class Image
 {
 public:
-	enum class PixelFormat // 32-bit colour: 8-bit per channel
+	enum class PixelFormat // 8-bit per channel
 	{
-		RGBA,
-		BGRA,
+		RGBA, // 32-bit colour
+		BGRA, // 32-bit colour
+		A8, // alpha only: reads as white with that alpha
+		L8, // luminance only: reads as opaque grey
+		LA8, // luminance and alpha
+		Indexed8, // an index into the palette: colours are written as the nearest colour in the palette
+	};
+
+	enum class BlendMode // source onto destination. with straight alpha, pixels are premultiplied for blending and unpremultiplied afterwards
+	{
+		SourceOver, // source drawn over destination
+		Additive, // source added to destination (clamped)
+		Multiply, // colours multiplied where both are covered, each kept where only one is
+	};
+
+	struct SourceTile // a rect of any source image to be composed into a tile of this image
+	{
+		const Image* image{ nullptr };
+		Rect rect{};
 	};
 
 	Image();
+	Image(const Image& other) = default;
+	Image(Image&& other) = default;
+	~Image();
 
-	void setSize(Xy size, bool clear = true, Pixel clearPixel = Pixel{ 0u, 0u, 0u, 255u });
-	void setSize(Xy size, const std::uint8_t* data);
+	void setSize(Xy size, bool clear = true, Pixel clearPixel = Pixel{ 0u, 0u, 0u, 255u }); // if not cleared, the content is unspecified after a change of size
+	void setSize(Xy size, const std::uint8_t* data); // data must be tightly packed (no row padding)
 	Xy getSize() const;
 	void resize(Xy newSize);
 	void resize(Xy newSize, Atlas& atlas); // resizes image and atlas together, keeping them synchronised. may affect atlas tile ratios, depending on size
@@ -66,35 +92,76 @@ public:
 	void setPixel(Xy location, Pixel pixel);
 	Pixel getPixel(Xy location) const;
 
-	void setPixelFormat(PixelFormat pixelFormat, bool convert = true);
+	void setPixelFormat(PixelFormat pixelFormat, bool convert = true); // if not converted and the number of values per pixel changes, the content is unspecified
 	PixelFormat getPixelFormat() const;
+	static std::size_t getNumberOfValuesPerPixel(PixelFormat pixelFormat);
+	std::size_t getNumberOfValuesPerPixel() const;
+
+	void setPalette(const std::vector<Pixel>& palette); // used by the Indexed8 format (up to 256 colours). indices are not changed
+	const std::vector<Pixel>& getPalette() const;
 
 	void setIsTopDown(bool isTopDown, bool convert = true);
 	bool getIsTopDown() const;
 
+	void setRowAlignment(std::size_t rowAlignment); // each row starts at a multiple of rowAlignment bytes (the data itself is always 64-byte aligned). 1 (the default) packs rows tightly
+	std::size_t getRowAlignment() const;
+	std::size_t getRowStride() const; // number of bytes from the start of one row to the start of the next in getData()
+
+	void setView(Xy size, const std::uint8_t* data, std::size_t rowStride = 0u, std::shared_ptr<const void> dataOwner = nullptr); // reads external data (in this image's format) without copying it. the data is copied into the image the first time it is edited. dataOwner (if any) is kept alive while the data is viewed
+	bool getIsView() const;
+	void takeOwnership(); // a view copies its data into the image now instead of when it is first edited. required before writing to the image from several threads at once
+
+	void setScratchPool(ScratchPool* scratchPool); // temporary buffers (and this image's data when it is destroyed) are taken from and returned to the pool. nullptr stops using a pool
+	ScratchPool* getScratchPool() const;
+
 	void flipVertically();
 
 	void clear(Pixel pixel = Pixel{ 0u, 0u, 0u, 255u });
 	void clear(Rect rect, Pixel pixel = Pixel{ 0u, 0u, 0u, 255u });
+	void clear(const Selection& selection, Pixel pixel = Pixel{ 0u, 0u, 0u, 255u }); // only the selected pixels
+	Rect fillRect(Rect rect, Pixel pixel = Pixel{ 0u, 0u, 0u, 255u }); // as clear but a rect that does not fit is clipped to the image instead of being ignored. returns the rect that was filled
 	void flip(bool horiz, bool vert, Rect rect = Rect{});
 	void rotate(Rect rect = Rect{}, bool clockwise = true);
 	void copy(Xy position, const Image& sourceImage, Rect sourceRect);
-	Rect copy(Xy position, const Image& sourceImage, Rect sourceRect, std::size_t expansion);
+	void copy(Xy position, const Image& sourceImage, Rect sourceRect, const Selection& sourceSelection); // as copy but only the pixels selected in sourceSelection (in the source image's locations)
+	Rect copy(Xy position, const Image& sourceImage, Rect sourceRect, std::size_t expansion); // copies the tile with its edges extruded by expansion directly into place. position is where the (unexpanded) tile is placed; returns the expanded Rect
+	Rect blit(Xy position, const Image& sourceImage, Rect sourceRect = Rect{}); // as copy but the source rect is clipped to the source image (and the result to this image) so a partial rect is copied instead of ignored. returns the rect that was written
+	bool blit(const Atlas& atlas, const Image& sourceImage, const Atlas& sourceAtlas); // blits each source tile to the atlas tile with the same index, clipped to the smaller of the two tiles. tiles that overlap the edges of either image are copied in part. destination tiles must not overlap. returns false if the sizes do not match
 	Rect expand(Rect rect, std::size_t expansion = 1u); // returns the expanded Rect. NOTE: expanded Rect MUST fit within the image otherwise an exception is thrown
 	void crop(Rect rect);
 	void invert(Rect rect = Rect{});
+	void premultiply(Rect rect = Rect{}); // multiplies colour by alpha. no effect on formats without both colour and alpha (A8, L8). Indexed8 processes its whole palette (rect is ignored)
+	void unpremultiply(Rect rect = Rect{}); // divides colour by alpha. colour is black where alpha is zero
+	void blend(Xy position, const Image& sourceImage, Rect sourceRect, BlendMode blendMode = BlendMode::SourceOver, bool isPremultiplied = false); // as copy but blends the source onto this image. isPremultiplied applies to both images
 	void replacePixel(Pixel newPixel, Pixel origPixel, Rect rect = Rect{});
+	void replacePixel(Pixel newPixel, Pixel origPixel, const Selection& selection); // only the selected pixels
+	void replacePixels(const std::vector<std::pair<Pixel, Pixel>>& replacements, Rect rect = Rect{}); // (original, new) pairs, all in one pass: each pixel is replaced at most once. the first pair for an original is used
+	void replacePixels(const std::vector<std::pair<Pixel, Pixel>>& replacements, const Atlas& atlas, std::size_t category); // as above within each tile of category. tiles must not overlap
+	void makeTransparent(Pixel colourKey, Rect rect = Rect{}); // pixels with colourKey's colour (whatever their alpha) get zero alpha, keeping their colour
 	void fill(Xy startPosition, Pixel replacementPixel, Rect boundary, double tolerance);
 	void fill(Xy startPosition, Pixel replacementPixel, Pixel targetPixel, Rect boundary, double tolerance);
 	void fill(Xy startPosition, Pixel replacementPixel, Rect boundary = Rect{}, Pixel tolerance = Pixel{});
 	void fill(Xy startPosition, Pixel replacementPixel, Pixel targetPixel, Rect boundary = Rect{}, Pixel tolerance = Pixel{});
 
+	void bleedAlpha(Rect rect = Rect{}); // gives each fully transparent pixel in the rect the colour of its nearest (within the rect) pixel that is not, keeping its alpha. no effect on formats without both colour and alpha (A8, L8, Indexed8)
+	void bleedAlpha(const Atlas& atlas); // as above, within each tile. tiles must not overlap
+
+	void generateDistanceField(Rect rect, std::size_t spread, std::uint8_t threshold = 128u, bool isMaskFromAlpha = true); // replaces the rect and a border of spread around it (within the image) with the signed distance field of its mask: pixels with alpha (or luminance) at or above threshold are inside. 128 is the edge, rising inwards and falling outwards by 127 over spread pixels. written to all channels
+	void generateDistanceField(const Atlas& atlas, std::size_t spread, std::uint8_t threshold = 128u, bool isMaskFromAlpha = true); // as above for each tile (in parallel), with the same spread for every tile. each tile with its border of spread must not overlap another's: tiles must be at least 2 * spread apart
+
 	void processPixels(const std::function<void(Pixel&)>& pixelProcessFunction, Rect rect = Rect{});
 	void processPixels(const std::function<void(Pixel&, const Xy xy)>& pixelProcessFunction, Rect rect = Rect{});
+	void processPixels(const std::function<void(Pixel&)>& pixelProcessFunction, const Selection& selection); // only the selected pixels
+
+	Selection selectColour(Pixel pixel, Pixel tolerance = Pixel{}, Rect rect = Rect{}) const; // pixels in the rect within tolerance of pixel (in each channel). the selection is the size of the image
+	Selection selectFill(Xy startPosition, Pixel tolerance = Pixel{}, Rect boundary = Rect{}) const; // the pixels that fill would replace
+	Selection selectAlpha(std::uint8_t threshold = 1u, Rect rect = Rect{}) const; // pixels in the rect with alpha at or above threshold
 
 	void expand(const Atlas& atlas, std::size_t expansion = 1u); // does not affect atlas - cannot expand its tiles
 	void expand(Atlas& atlas, bool expandAtlasTiles = false, std::size_t expansion = 1u);
-	bool transfer(Atlas& atlas, const Image& sourceImage, const Atlas& sourceAtlas, std::size_t amountOfExpansionIncluded = 0u);
+	bool transfer(Atlas& atlas, const Image& sourceImage, const Atlas& sourceAtlas, std::size_t amountOfExpansionIncluded = 0u); // copies each source tile to the atlas tile with the same index (see compose). destination tiles (with their expansion) must not overlap
+	bool transfer(const Atlas& atlas, const Image& sourceImage, const Atlas& sourceAtlas, BlendMode blendMode, bool isPremultiplied = false); // blends each source tile onto the atlas tile with the same index. destination tiles must not overlap. returns false if the sizes do not match
+	bool compose(const Atlas& atlas, const std::vector<SourceTile>& sourceTiles, std::size_t amountOfExpansionIncluded = 0u); // copies each source tile (from its own image) to the atlas tile with the same index. pixel formats are converted during the copy. destination tiles (with their expansion) must not overlap. returns false if the sizes do not match
 	void trimAtlas(Atlas& atlas, Pixel pixelToTrim = Pixel{ 0u, 0u, 0u, 0u }) const;
 
 	Xy joinGridTiles(
@@ -127,20 +194,69 @@ public:
 		std::size_t category = 0u,
 		std::size_t initId = 0u);
 
-	const std::uint8_t* getData() const;
+	const std::uint8_t* getData() const; // rows are getRowStride() bytes apart
+	const std::uint8_t* getRowData(std::size_t y) const; // the first byte of (stored) row y, in the image's pixel format
+	std::uint8_t* accessRowData(std::size_t y); // as getRowData but writable. a view copies its data first
 
 private:
-	const std::size_t m_numberOfValuesPerPixel;
+	std::size_t m_numberOfValuesPerPixel;
 	bool m_isTopDown;
 	PixelFormat m_pixelFormat;
 	Xy m_size;
-	std::vector<std::uint8_t> m_data;
+	std::size_t m_rowAlignment;
+	std::size_t m_rowStride;
+	ScratchPool* m_scratchPool;
+	AlignedBuffer m_data;
+	const std::uint8_t* m_viewData;
+	std::shared_ptr<const void> m_viewDataOwner;
+	std::vector<Pixel> m_palette;
 
 	bool priv_isValidIndex(const std::size_t index) const;
 	std::size_t priv_getIndexFromLocation(const Xy location) const;
+	std::size_t priv_getDataIndex(const std::size_t index) const;
+	std::size_t priv_getRowStride(const std::size_t width) const;
+	AlignedBuffer priv_acquireBuffer(const std::size_t size);
+	void priv_releaseBuffer(AlignedBuffer&& buffer);
+	void priv_allocate(const Xy size);
+	const std::uint8_t* priv_getData() const;
+	std::uint8_t* priv_getMutableData();
+	void priv_dropView();
 	void priv_setPixel(const std::size_t index, const Pixel& pixel);
 	Pixel priv_getPixel(const std::size_t index) const;
+	void priv_encodePixel(std::uint8_t* data, const Pixel& pixel) const;
+	Pixel priv_decodePixel(const std::uint8_t* data) const;
+	Pixel priv_getStoredPixel(const Pixel& pixel) const;
+	std::uint8_t priv_getNearestPaletteIndex(const Pixel& pixel) const;
+	std::uint8_t* priv_getPixelData(const Xy location);
+	const std::uint8_t* priv_getPixelData(const Xy location) const;
+	void priv_copyPixels(std::uint8_t* destination, const Image& sourceImage, const std::uint8_t* source, const std::size_t numberOfPixels);
+	void priv_splatPixel(std::uint8_t* destination, const std::uint8_t* pixelData, const std::size_t numberOfPixels);
+	bool priv_clipSourceRect(const Xy position, const Image& sourceImage, Rect& sourceRect) const; // returns false if nothing can be copied
+	void priv_copyRows(const Xy position, const Image& sourceImage, const Rect sourceRect);
+	void priv_fillRect(const Rect rect, const Pixel pixel); // rect must be within the image and have a size
+	Selection priv_select(Rect rect, const std::function<bool(const Pixel&)>& isSelected) const;
+	void priv_replacePixels(const std::vector<std::pair<Pixel, Pixel>>& replacements, const std::vector<Rect>& rects);
+	void priv_forEachRow(const std::vector<Rect>& rects, const std::function<void(std::uint8_t*, std::size_t)>& rowFunction); // calls rowFunction(data, numberOfPixels) for each row of the rects (clipped to the image) in parallel
+	void priv_blendRows(const Xy position, const Image& sourceImage, const Rect sourceRect, const BlendMode blendMode, const bool isPremultiplied);
+	void priv_processAlpha(Rect rect, const bool isPremultiplying);
+	void priv_bleedAlpha(Rect rect);
+	void priv_generateDistanceField(const Rect rect, const std::size_t spread, const std::uint8_t threshold, const bool isMaskFromAlpha);
+	static void priv_transformDistances(float* values, const std::size_t numberOfValues, const std::size_t step, std::vector<float>& distances, std::vector<std::size_t>& parabolas, std::vector<float>& boundaries);
+	static void priv_blendPixel(std::uint8_t* destination, const std::uint8_t* source, const BlendMode blendMode, const bool isPremultiplied); // four channels with alpha last
+	static std::uint8_t priv_multiplyChannels(const std::uint32_t a, const std::uint32_t b); // a * b / 255, rounded
+	void priv_extrude(const Rect rect, const std::size_t expansion);
+	bool priv_separateGridTiles(
+		const Xy startPosition,
+		const Xy offset,
+		const Xy gridSize,
+		const Xy tileSize,
+		Xy& separation,
+		std::size_t& expansion,
+		const Xy origSeparation,
+		const bool emptyOrig,
+		const Pixel emptyPixel);
 	bool priv_rectHasNoSize(const Rect rect) const;
+	bool priv_isRectWithinImage(const Rect rect) const; // (its position must also be a location in the image)
 	void priv_makeRectFullImageSizeIfHasNoSize(Rect& rect) const;
 };
 
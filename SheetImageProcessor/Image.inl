@@ -35,6 +35,9 @@
 #include "Atlas.hpp"
 
 #include <queue>
+#include <cstring>
+#include <cmath>
+#include <limits>
 
 //#include <iostream>
 
@@ -46,32 +49,37 @@ inline Image::Image()
 	, m_isTopDown{ true }
 	, m_pixelFormat{ PixelFormat::RGBA }
 	, m_size{ 0u, 0u }
+	, m_rowAlignment{ 1u }
+	, m_rowStride{ 0u }
+	, m_scratchPool{ nullptr }
 	, m_data{}
+	, m_viewData{ nullptr }
+	, m_viewDataOwner{}
+	, m_palette{}
 {
 
 }
 
+inline Image::~Image()
+{
+	priv_releaseBuffer(std::move(m_data));
+}
+
 inline void Image::setSize(const Xy size, const bool clear, const Pixel clearPixel)
 {
 	if ((size == m_size) && (!clear))
 		return;
-	if ((m_size.x * m_size.y) != (size.x * size.y))
-		m_data.resize(size.x * size.y * m_numberOfValuesPerPixel);
-	m_size = size;
+	priv_allocate(size);
 	if (clear)
-	{
-		const std::size_t numberOfPixels{ m_size.x * m_size.y };
-		for (std::size_t i{ 0u }; i < numberOfPixels; ++i)
-			setPixel(i, clearPixel);
-	}
+		Image::clear(clearPixel);
 }
 
 inline void Image::setSize(const Xy size, const std::uint8_t* data)
 {
-	setSize(size, false);
-	const std::size_t dataSize{ m_data.size()};
-	for (std::size_t i{ 0u }; i < dataSize; ++i)
-		m_data[i] = data[i];
+	priv_allocate(size);
+	const std::size_t rowSize{ m_size.x * m_numberOfValuesPerPixel };
+	for (std::size_t y{ 0u }; y < m_size.y; ++y)
+		std::memcpy(m_data.data() + (y * m_rowStride), data + (y * rowSize), rowSize);
 }
 
 inline Xy Image::getSize() const
@@ -81,21 +89,37 @@ inline Xy Image::getSize() const
 
 inline void Image::resize(const Xy newSize)
 {
-	Image result{};
-	result.setIsTopDown(getIsTopDown());
-	result.setPixelFormat(getPixelFormat());
-	result.setSize(newSize);
+	if (priv_rectHasNoSize({ { 0u, 0u }, m_size }))
+	{
+		setSize(newSize, true, Pixel{ 0u, 0u, 0u, 0u });
+		return;
+	}
+
+	const std::size_t newRowStride{ priv_getRowStride(newSize.x) };
+	AlignedBuffer result{ priv_acquireBuffer(newRowStride * newSize.y) };
+
+	// nearest neighbour: each destination row is built once from the source row it samples and then repeated while the source row is the same
+	std::vector<std::size_t> sourceOffsets(newSize.x);
+	for (std::size_t x{ 0u }; x < newSize.x; ++x)
+		sourceOffsets[x] = (x * m_size.x / newSize.x) * m_numberOfValuesPerPixel;
 	for (std::size_t y{ 0u }; y < newSize.y; ++y)
 	{
+		std::uint8_t* destinationRow{ result.data() + (y * newRowStride) };
 		const std::size_t sourceY{ y * m_size.y / newSize.y };
-		for (std::size_t x{ 0u }; x < newSize.x; ++x)
+		if ((y > 0u) && (sourceY == ((y - 1u) * m_size.y / newSize.y)))
 		{
-			const std::size_t sourceX{ x * m_size.x / newSize.x };
-			result.setPixel({ x, y }, getPixel({ sourceX, sourceY }));
+			std::memcpy(destinationRow, destinationRow - newRowStride, newSize.x * m_numberOfValuesPerPixel);
+			continue;
 		}
+		const std::uint8_t* sourceRow{ priv_getData() + (sourceY * m_rowStride) };
+		for (std::size_t x{ 0u }; x < newSize.x; ++x)
+			std::memcpy(destinationRow + (x * m_numberOfValuesPerPixel), sourceRow + sourceOffsets[x], m_numberOfValuesPerPixel);
 	}
+	priv_dropView();
 	m_size = newSize;
-	m_data = result.m_data;
+	m_rowStride = newRowStride;
+	m_data.swap(result);
+	priv_releaseBuffer(std::move(result));
 }
 
 inline void Image::resize(const Xy newSize, Atlas& atlas)
@@ -139,18 +163,49 @@ inline void Image::setPixelFormat(const PixelFormat pixelFormat, const bool conv
 {
 	if (pixelFormat == m_pixelFormat)
 		return;
-	m_pixelFormat = pixelFormat;
+	const std::size_t numberOfValuesPerPixel{ getNumberOfValuesPerPixel(pixelFormat) };
 
-	if (convert)
+	if (!convert || priv_rectHasNoSize({ { 0u, 0u }, m_size }))
+	{
+		m_pixelFormat = pixelFormat;
+		if (numberOfValuesPerPixel != m_numberOfValuesPerPixel)
+		{
+			m_numberOfValuesPerPixel = numberOfValuesPerPixel;
+			priv_allocate(m_size);
+		}
+		return;
+	}
+
+	if ((pixelFormat == PixelFormat::Indexed8) && m_palette.empty())
+		throw Exception("Cannot convert to indexed pixel format: palette is empty.");
+
+	// RGBA <-> BGRA: swap red and blue in place
+	if ((numberOfValuesPerPixel == 4u) && (m_numberOfValuesPerPixel == 4u))
 	{
-		const std::size_t dataSize{ m_data.size() };
-		for (std::size_t i{ 0u }; i < dataSize; i += 4u)
+		m_pixelFormat = pixelFormat;
+		std::uint8_t* data{ priv_getMutableData() };
+		for (std::size_t y{ 0u }; y < m_size.y; ++y)
 		{
-			const std::uint8_t tempValue{ m_data[i] };
-			m_data[i] = m_data[i + 2u];
-			m_data[i + 2u] = tempValue;
+			std::uint8_t* row{ data + (y * m_rowStride) };
+			for (std::size_t x{ 0u }; x < m_size.x; ++x)
+				std::swap(row[x * 4u], row[(x * 4u) + 2u]);
 		}
+		return;
 	}
+
+	// other conversions are copied (and converted) row by row into new data
+	Image converted{};
+	converted.setScratchPool(m_scratchPool);
+	converted.setRowAlignment(m_rowAlignment);
+	converted.m_palette = m_palette;
+	converted.setPixelFormat(pixelFormat, false);
+	converted.setSize(m_size, false);
+	converted.priv_copyRows({ 0u, 0u }, *this, { { 0u, 0u }, m_size });
+	priv_dropView();
+	m_data.swap(converted.m_data);
+	m_rowStride = converted.m_rowStride;
+	m_pixelFormat = pixelFormat;
+	m_numberOfValuesPerPixel = numberOfValuesPerPixel;
 }
 
 inline Image::PixelFormat Image::getPixelFormat() const
@@ -158,6 +213,40 @@ inline Image::PixelFormat Image::getPixelFormat() const
 	return m_pixelFormat;
 }
 
+inline std::size_t Image::getNumberOfValuesPerPixel(const PixelFormat pixelFormat)
+{
+	switch (pixelFormat)
+	{
+	case PixelFormat::A8:
+	case PixelFormat::L8:
+	case PixelFormat::Indexed8:
+		return 1u;
+	case PixelFormat::LA8:
+		return 2u;
+	case PixelFormat::RGBA:
+	case PixelFormat::BGRA:
+	default:
+		return 4u;
+	}
+}
+
+inline std::size_t Image::getNumberOfValuesPerPixel() const
+{
+	return m_numberOfValuesPerPixel;
+}
+
+inline void Image::setPalette(const std::vector<Pixel>& palette)
+{
+	if (palette.size() > 256u)
+		throw Exception("Cannot set palette: more than 256 colours.");
+	m_palette = palette;
+}
+
+inline const std::vector<Pixel>& Image::getPalette() const
+{
+	return m_palette;
+}
+
 inline void Image::setIsTopDown(bool isTopDown, const bool convert)
 {
 	if (isTopDown == m_isTopDown)
@@ -172,51 +261,139 @@ inline bool Image::getIsTopDown() const
 	return m_isTopDown;
 }
 
+inline void Image::setRowAlignment(std::size_t rowAlignment)
+{
+	if (rowAlignment == 0u)
+		rowAlignment = 1u;
+	if (rowAlignment == m_rowAlignment)
+		return;
+	m_rowAlignment = rowAlignment;
+
+	const std::size_t newRowStride{ priv_getRowStride(m_size.x) };
+	if (newRowStride == m_rowStride)
+		return;
+	AlignedBuffer data{ priv_acquireBuffer(newRowStride * m_size.y) };
+	const std::size_t rowSize{ m_size.x * m_numberOfValuesPerPixel };
+	for (std::size_t y{ 0u }; y < m_size.y; ++y)
+		std::memcpy(data.data() + (y * newRowStride), priv_getData() + (y * m_rowStride), rowSize);
+	priv_dropView();
+	m_rowStride = newRowStride;
+	m_data.swap(data);
+	priv_releaseBuffer(std::move(data));
+}
+
+inline std::size_t Image::getRowAlignment() const
+{
+	return m_rowAlignment;
+}
+
+inline std::size_t Image::getRowStride() const
+{
+	return m_rowStride;
+}
+
+inline void Image::setView(const Xy size, const std::uint8_t* data, std::size_t rowStride, std::shared_ptr<const void> dataOwner)
+{
+	const std::size_t rowSize{ size.x * m_numberOfValuesPerPixel };
+	if (rowStride == 0u)
+		rowStride = rowSize;
+	if (rowStride < rowSize)
+		throw Exception("Cannot view data: row stride is smaller than a row.");
+
+	priv_releaseBuffer(std::move(m_data));
+	m_data = AlignedBuffer{};
+	m_size = size;
+	m_rowStride = rowStride;
+	m_viewData = data;
+	m_viewDataOwner = std::move(dataOwner);
+	if ((m_viewData == nullptr) && ((size.x * size.y) > 0u))
+		throw Exception("Cannot view data: data is null.");
+}
+
+inline bool Image::getIsView() const
+{
+	return (m_viewData != nullptr);
+}
+
+inline void Image::takeOwnership()
+{
+	priv_getMutableData();
+}
+
+inline void Image::setScratchPool(ScratchPool* scratchPool)
+{
+	m_scratchPool = scratchPool;
+}
+
+inline ScratchPool* Image::getScratchPool() const
+{
+	return m_scratchPool;
+}
+
 inline void Image::flipVertically()
 {
 	const std::size_t halfHeight{ m_size.y / 2u };
+	const std::size_t rowSize{ m_size.x * m_numberOfValuesPerPixel };
+	std::uint8_t* data{ priv_getMutableData() };
 	for (std::size_t y{ 0u }; y < halfHeight; ++y)
 	{
-		const std::size_t oppositeY{ m_size.y - y - 1u };
-		for (std::size_t x{ 0u }; x < m_size.x; ++x)
-		{
-			Pixel temp{ getPixel({ x, y }) };
-			setPixel({ x, y }, getPixel({ x, oppositeY }));
-			setPixel({ x, oppositeY }, temp);
-		}
+		std::uint8_t* row{ data + (y * m_rowStride) };
+		std::swap_ranges(row, row + rowSize, data + ((m_size.y - y - 1u) * m_rowStride));
 	}
 }
 
 inline void Image::clear(const Pixel pixel)
 {
-	const std::size_t numberOfPixels{ m_data.size() };
-	for (std::size_t i{ 0u }; i < numberOfPixels; ++i)
-		setPixel(i, pixel);
+	clear({ { 0u, 0u }, m_size }, pixel);
 }
 
 inline void Image::clear(const Rect rect, const Pixel pixel)
 {
-	if ((rect.position.x >= m_size.x) ||
-		(rect.position.y >= m_size.y) ||
-		((rect.position.x + rect.size.x) > m_size.x) ||
-		((rect.position.y + rect.size.y) > m_size.y))
+	if (!priv_isRectWithinImage(rect))
 		return;
-	for (std::size_t y{ 0u }; y < rect.size.y; ++y)
+	if (priv_rectHasNoSize(rect))
+		return;
+
+	priv_fillRect(rect, pixel);
+}
+
+inline Rect Image::fillRect(Rect rect, const Pixel pixel)
+{
+	rect = rect.getClamped(m_size);
+	if (priv_rectHasNoSize(rect))
+		return {};
+
+	priv_fillRect(rect, pixel);
+	return rect;
+}
+
+inline void Image::priv_fillRect(const Rect rect, const Pixel pixel)
+{
+	// set the first row and then copy it to the others
+	std::uint8_t* firstRow{ priv_getPixelData(rect.position) };
+	priv_setPixel(priv_getIndexFromLocation(rect.position), pixel);
+	priv_splatPixel(firstRow + m_numberOfValuesPerPixel, firstRow, rect.size.x - 1u);
+	const std::size_t rowSize{ rect.size.x * m_numberOfValuesPerPixel };
+	for (std::size_t y{ 1u }; y < rect.size.y; ++y)
+		std::memcpy(priv_getPixelData({ rect.position.x, rect.position.y + y }), firstRow, rowSize);
+}
+
+inline void Image::clear(const Selection& selection, const Pixel pixel)
+{
+	std::array<std::uint8_t, 4u> pixelData{};
+	priv_encodePixel(pixelData.data(), pixel);
+	selection.forEachSelected([&](const Xy location)
 	{
-		const std::size_t rectY{ rect.position.y + y };
-		for (std::size_t x{ 0u }; x < rect.size.x; ++x)
-			setPixel({ rect.position.x + x, rectY }, pixel);
-	}
+		if ((location.x < m_size.x) && (location.y < m_size.y))
+			std::memcpy(priv_getPixelData(location), pixelData.data(), m_numberOfValuesPerPixel);
+	});
 }
 
 inline void Image::flip(const bool horiz, const bool vert, Rect rect)
 {
 	if (!(horiz || vert))
 		return;
-	if ((rect.position.x >= m_size.x) ||
-		(rect.position.y >= m_size.y) ||
-		((rect.position.x + rect.size.x) > m_size.x) ||
-		((rect.position.y + rect.size.y) > m_size.y))
+	if (!priv_isRectWithinImage(rect))
 		return;
 
 	priv_makeRectFullImageSizeIfHasNoSize(rect);
@@ -239,10 +416,7 @@ inline void Image::rotate(Rect rect, const bool clockwise)
 {
 	if (rect.size.x != rect.size.y)
 		return;
-	if ((rect.position.x >= m_size.x) ||
-		(rect.position.y >= m_size.y) ||
-		((rect.position.x + rect.size.x) > m_size.x) ||
-		((rect.position.y + rect.size.y) > m_size.y))
+	if (!priv_isRectWithinImage(rect))
 		return;
 
 	priv_makeRectFullImageSizeIfHasNoSize(rect);
@@ -283,21 +457,92 @@ inline void Image::copy(Xy position, const Image& sourceImage, Rect sourceRect)
 		sourceRect.size.x = sourceImageSize.x - position.x;
 		sourceRect.size.y = sourceImageSize.y - position.y;
 	}
-	if ((sourceRect.position.x >= sourceImageSize.x) ||
-		(sourceRect.position.y >= sourceImageSize.y) ||
-		((sourceRect.position.x + sourceRect.size.x) > sourceImageSize.x) ||
-		((sourceRect.position.y + sourceRect.size.y) > sourceImageSize.y))
+	if (!priv_clipSourceRect(position, sourceImage, sourceRect))
+		return;
+	priv_copyRows(position, sourceImage, sourceRect);
+}
+
+inline Rect Image::blit(const Xy position, const Image& sourceImage, Rect sourceRect)
+{
+	const Xy sourceImageSize{ sourceImage.getSize() };
+	if (priv_rectHasNoSize(sourceRect))
+		sourceRect = { { 0u, 0u }, sourceImageSize };
+
+	// clip once against both images. the rows are then copied without any further checks
+	sourceRect = sourceRect.getClamped(sourceImageSize);
+	const Rect destinationRect{ Rect{ position, sourceRect.size }.getClamped(m_size) };
+	if (priv_rectHasNoSize(destinationRect))
+		return {};
+
+	priv_copyRows(destinationRect.position, sourceImage, { sourceRect.position, destinationRect.size });
+	return destinationRect;
+}
+
+inline bool Image::blit(const Atlas& atlas, const Image& sourceImage, const Atlas& sourceAtlas)
+{
+	const std::size_t atlasSize{ atlas.getSize() };
+	if (atlasSize != sourceAtlas.getSize())
+		return false;
+
+	const std::vector<Atlas::Tile>& tiles{ atlas.constAccess() };
+	const std::vector<Atlas::Tile>& sourceTiles{ sourceAtlas.constAccess() };
+	const std::vector<std::size_t> order{ atlas.getBlitOrder(sourceAtlas) };
+	auto blitTile = [&](const std::size_t orderIndex)
+	{
+		const std::size_t i{ order[orderIndex] };
+		const Rect& rect{ tiles[i].rect };
+		const Rect& sourceRect{ sourceTiles[i].rect };
+		const Rect clippedSourceRect{ sourceRect.position, { std::min(rect.size.x, sourceRect.size.x), std::min(rect.size.y, sourceRect.size.y) } };
+		if (!priv_rectHasNoSize(clippedSourceRect)) // (no size would mean the whole source image)
+			blit(rect.position, sourceImage, clippedSourceRect);
+	};
+
+	// destination tiles are independent unless this image is also the source
+	if (&sourceImage == this)
+	{
+		for (std::size_t i{ 0u }; i < atlasSize; ++i)
+			blitTile(i);
+	}
+	else
+	{
+		takeOwnership();
+		Parallel::forEach(atlasSize, blitTile);
+	}
+	return true;
+}
+
+inline void Image::copy(const Xy position, const Image& sourceImage, Rect sourceRect, const Selection& sourceSelection)
+{
+	const Xy sourceImageSize{ sourceImage.getSize() };
+	if ((sourceRect.size.x == 0u) || (sourceRect.size.y == 0u))
+	{
+		sourceRect.size.x = sourceImageSize.x - position.x;
+		sourceRect.size.y = sourceImageSize.y - position.y;
+	}
+	if (!priv_clipSourceRect(position, sourceImage, sourceRect))
 		return;
 
+	// a source within this image is copied out first in case it overlaps
+	const Image* readImage{ &sourceImage };
+	Xy readPosition{ sourceRect.position };
+	Image sourceCopy{};
+	if (&sourceImage == this)
+	{
+		sourceCopy.setScratchPool(m_scratchPool);
+		sourceCopy.setPalette(m_palette);
+		sourceCopy.setPixelFormat(m_pixelFormat, false);
+		sourceCopy.setSize(sourceRect.size, false);
+		sourceCopy.copy({ 0u, 0u }, *this, sourceRect);
+		readImage = &sourceCopy;
+		readPosition = { 0u, 0u };
+	}
+
 	for (std::size_t y{ 0u }; y < sourceRect.size.y; ++y)
 	{
-		const std::size_t sourceY{ sourceRect.position.y + y };
-		const std::size_t destinationY{ position.y + y };
 		for (std::size_t x{ 0u }; x < sourceRect.size.x; ++x)
 		{
-			const std::size_t sourceX{ sourceRect.position.x + x };
-			const std::size_t destinationX{ position.x + x };
-			setPixel({ destinationX, destinationY }, sourceImage.getPixel({ sourceX, sourceY }));
+			if (sourceSelection.get({ sourceRect.position.x + x, sourceRect.position.y + y }))
+				priv_copyPixels(priv_getPixelData({ position.x + x, position.y + y }), *readImage, readImage->priv_getPixelData({ readPosition.x + x, readPosition.y + y }), 1u);
 		}
 	}
 }
@@ -318,8 +563,18 @@ inline Rect Image::copy(Xy position, const Image& sourceImage, Rect sourceRect,
 		((sourceRect.position.y + sourceRect.size.y) > sourceImageSize.y))
 		return {};
 
+	const Xy contentPosition{ position };
 	position -= { expansion, expansion };
 	const Xy expandedSize{ sourceRect.size + Xy{ expansion + expansion, expansion + expansion } };
+
+	// fast path: the whole expanded tile fits so copy its content rows directly into place and then extrude them
+	if (((position.x + expandedSize.x) <= m_size.x) && ((position.y + expandedSize.y) <= m_size.y))
+	{
+		priv_copyRows(contentPosition, sourceImage, sourceRect);
+		priv_extrude({ contentPosition, sourceRect.size }, expansion);
+		return { position, expandedSize };
+	}
+
 	for (std::size_t y{ 0u }; y < expandedSize.y; ++y)
 	{
 		std::size_t sourceY{ sourceRect.position.y };
@@ -365,33 +620,7 @@ inline Rect Image::expand(const Rect rect, const std::size_t expansion)
 	Rect expandedRect{ rect };
 	expandedRect.position -= { expansion, expansion };
 	expandedRect.size += { doubleExpansion, doubleExpansion };
-	const std::size_t longestDimension{ std::max(rect.size.x, rect.size.y) };
-	const std::size_t shortestDimension{ std::min(rect.size.x, rect.size.y) };
-	const bool isWider{ rect.size.x > rect.size.y };
-	for (std::size_t e{ 1u }; e <= expansion; ++e)
-	{
-		const Xy leftTop{ rect.position - Xy{ e, e } };
-		const Xy rightBottom{ rect.position + rect.size + Xy{ e - 1u, e - 1u } };
-		const std::size_t doubleE{ e * 2u };
-		for (std::size_t i{ 1u }; i < longestDimension + doubleE; ++i)
-		{
-			const bool isBothDimensions{ i < (shortestDimension + doubleE) };
-			if (isBothDimensions || isWider)
-			{
-				Xy top{ leftTop.x + i, leftTop.y }; // top-left going right (missing top-left corner)
-				Xy bottom{ rightBottom.x - i, rightBottom.y }; // bottom-right going left (missing bottom-right corner)
-				setPixel(top, getPixel(top + Xy{ 0u, 1u }));
-				setPixel(bottom, getPixel(bottom - Xy{ 0u, 1u }));
-			}
-			if (isBothDimensions || !isWider)
-			{
-				Xy left{ leftTop.x, rightBottom.y - i }; // bottom-left going up (missing bottom-left corner)
-				Xy right{ rightBottom.x, leftTop.y + i }; // top-right going down (missing top-right corner)
-				setPixel(left, getPixel(left + Xy{ 1u, 0u }));
-				setPixel(right, getPixel(right - Xy{ 1u, 0u }));
-			}
-		}
-	}
+	priv_extrude(rect, expansion);
 
 	return expandedRect;
 }
@@ -403,12 +632,21 @@ inline void Image::crop(Rect rect)
 		setSize({ 0u, 0u });
 		return;
 	}
-	Image copyImage{};
-	copyImage.setSize(rect.size);
-	copyImage.copy({ 0u, 0u }, *this, rect);
-	setSize(rect.size);
-	rect.position = { 0u, 0u };
-	copy({ 0u, 0u }, copyImage, rect);
+	if (((rect.position.x + rect.size.x) > m_size.x) || ((rect.position.y + rect.size.y) > m_size.y))
+	{
+		setSize(rect.size);
+		return;
+	}
+
+	// move the rows into place within the current data. each row's destination never overlaps a later row's source
+	takeOwnership();
+	const std::size_t newRowStride{ priv_getRowStride(rect.size.x) };
+	const std::size_t rowSize{ rect.size.x * m_numberOfValuesPerPixel };
+	for (std::size_t y{ 0u }; y < rect.size.y; ++y)
+		std::memmove(m_data.data() + (y * newRowStride), priv_getPixelData({ rect.position.x, rect.position.y + y }), rowSize);
+	m_data.resize(newRowStride * rect.size.y);
+	m_size = rect.size;
+	m_rowStride = newRowStride;
 }
 
 inline void Image::invert(Rect rect)
@@ -428,6 +666,47 @@ inline void Image::invert(Rect rect)
 	}
 }
 
+inline void Image::premultiply(const Rect rect)
+{
+	priv_processAlpha(rect, true);
+}
+
+inline void Image::unpremultiply(const Rect rect)
+{
+	priv_processAlpha(rect, false);
+}
+
+inline void Image::blend(const Xy position, const Image& sourceImage, Rect sourceRect, const BlendMode blendMode, const bool isPremultiplied)
+{
+	const Xy sourceImageSize{ sourceImage.getSize() };
+	if ((sourceRect.size.x == 0u) || (sourceRect.size.y == 0u))
+	{
+		sourceRect.size.x = sourceImageSize.x - position.x;
+		sourceRect.size.y = sourceImageSize.y - position.y;
+	}
+	if (!priv_clipSourceRect(position, sourceImage, sourceRect))
+		return;
+
+	// blending reads the destination so a source within this image is copied out first in case they overlap
+	if (&sourceImage == this)
+	{
+		Image sourceCopy{};
+		sourceCopy.setScratchPool(m_scratchPool);
+		sourceCopy.setPalette(m_palette);
+		sourceCopy.setPixelFormat(m_pixelFormat, false);
+		sourceCopy.setSize(sourceRect.size, false);
+		sourceCopy.copy({ 0u, 0u }, *this, sourceRect);
+		priv_blendRows(position, sourceCopy, { { 0u, 0u }, sourceRect.size }, blendMode, isPremultiplied);
+		return;
+	}
+
+	takeOwnership();
+	Parallel::forEach(sourceRect.size.y, [&](const std::size_t y)
+	{
+		priv_blendRows({ position.x, position.y + y }, sourceImage, { { sourceRect.position.x, sourceRect.position.y + y }, { sourceRect.size.x, 1u } }, blendMode, isPremultiplied);
+	});
+}
+
 inline void Image::replacePixel(const Pixel newPixel, const Pixel origPixel, Rect rect)
 {
 	priv_makeRectFullImageSizeIfHasNoSize(rect);
@@ -442,6 +721,68 @@ inline void Image::replacePixel(const Pixel newPixel, const Pixel origPixel, Rec
 	}
 }
 
+inline void Image::replacePixel(const Pixel newPixel, const Pixel origPixel, const Selection& selection)
+{
+	selection.forEachSelected([&](const Xy location)
+	{
+		if ((location.x < m_size.x) && (location.y < m_size.y) && (getPixel(location) == origPixel))
+			setPixel(location, newPixel);
+	});
+}
+
+inline void Image::replacePixels(const std::vector<std::pair<Pixel, Pixel>>& replacements, Rect rect)
+{
+	priv_makeRectFullImageSizeIfHasNoSize(rect);
+	priv_replacePixels(replacements, { rect });
+}
+
+inline void Image::replacePixels(const std::vector<std::pair<Pixel, Pixel>>& replacements, const Atlas& atlas, const std::size_t category)
+{
+	std::vector<Rect> rects{};
+	for (const Atlas::Tile& tile : atlas.constAccess())
+	{
+		if (tile.category == category)
+			rects.push_back(tile.rect);
+	}
+	priv_replacePixels(replacements, rects);
+}
+
+inline void Image::makeTransparent(const Pixel colourKey, Rect rect)
+{
+	priv_makeRectFullImageSizeIfHasNoSize(rect);
+
+	// 32-bit colour is compared in place; other formats go through Pixel
+	if (m_numberOfValuesPerPixel == 4u)
+	{
+		const bool isBgra{ m_pixelFormat == PixelFormat::BGRA };
+		const std::array<std::uint8_t, 3u> key{ isBgra ? colourKey.b : colourKey.r, colourKey.g, isBgra ? colourKey.r : colourKey.b };
+		priv_forEachRow({ rect }, [&key](std::uint8_t* data, const std::size_t numberOfPixels)
+		{
+			for (std::size_t i{ 0u }; i < numberOfPixels; ++i)
+			{
+				std::uint8_t* pixel{ data + (i * 4u) };
+				if ((pixel[0u] == key[0u]) && (pixel[1u] == key[1u]) && (pixel[2u] == key[2u]))
+					pixel[3u] = 0u;
+			}
+		});
+		return;
+	}
+
+	priv_forEachRow({ rect }, [&](std::uint8_t* data, const std::size_t numberOfPixels)
+	{
+		for (std::size_t i{ 0u }; i < numberOfPixels; ++i)
+		{
+			std::uint8_t* pixelData{ data + (i * m_numberOfValuesPerPixel) };
+			Pixel pixel{ priv_decodePixel(pixelData) };
+			if ((pixel.r == colourKey.r) && (pixel.g == colourKey.g) && (pixel.b == colourKey.b) && (pixel.a != 0u))
+			{
+				pixel.a = 0u;
+				priv_encodePixel(pixelData, pixel);
+			}
+		}
+	});
+}
+
 inline void Image::fill(const Xy startPosition, const Pixel pixel, Rect boundary, const double tolerance)
 {
 	priv_makeRectFullImageSizeIfHasNoSize(boundary);
@@ -463,45 +804,50 @@ inline void Image::fill(Xy startPosition, Pixel replacementPixel, Pixel targetPi
 		fill(startPosition, replacementPixel, targetPixel, boundary, Pixel{ 0u, 0u, 0u, 0u });
 		return;
 	}
+	if ((startPosition.x >= m_size.x) || (startPosition.y >= m_size.y))
+		return;
+	// pixels outside the image cannot be filled so the search stays within it. this also keeps every position representable by the compact queue coordinates
+	boundary.size.x = std::min(boundary.size.x, m_size.x - boundary.position.x);
+	boundary.size.y = std::min(boundary.size.y, m_size.y - boundary.position.y);
 
 	if (tolerance > 1.0)
 		tolerance = 1.0;
+	replacementPixel = priv_getStoredPixel(replacementPixel);
 	const Pixel startPixel{ getPixel(startPosition) };
 	const Xy position{ startPosition };
 	Image& image{ *this };
-	auto amountOfDifferenceBetweenTwoPixels = [](const Pixel& pixel, const Pixel& reference)
-	{
-		const int differenceR{ static_cast<int>(pixel.r) - static_cast<int>(reference.r) };
-		const int differenceG{ static_cast<int>(pixel.g) - static_cast<int>(reference.g) };
-		const int differenceB{ static_cast<int>(pixel.b) - static_cast<int>(reference.b) };
-		const int differenceA{ static_cast<int>(pixel.a) - static_cast<int>(reference.a) };
-		constexpr double maxDifference{ 255.0 + 255.0 + 255.0 + 255.0 };
-		constexpr double maxDifferenceMultiplier{ 1.0 / maxDifference };
-		return (static_cast<double>(std::abs(differenceR)) + static_cast<double>(std::abs(differenceG)) +
-			static_cast<double>(std::abs(differenceB)) + static_cast<double>(std::abs(differenceA))) * maxDifferenceMultiplier;
-	};
-	std::queue<Xy> q{};
-	q.push(position);
+	// tolerance is a fraction of the largest total difference (of all four channels). it is turned into the largest whole total difference within it so each pixel is a single integer test
+	constexpr double maxDifference{ 255.0 + 255.0 + 255.0 + 255.0 };
+	constexpr double maxDifferenceMultiplier{ 1.0 / maxDifference };
+	std::uint32_t maxTotalDifference{ static_cast<std::uint32_t>(tolerance * maxDifference) };
+	while ((maxTotalDifference < 1020u) && ((static_cast<double>(maxTotalDifference + 1u) * maxDifferenceMultiplier) <= tolerance))
+		++maxTotalDifference;
+	while ((maxTotalDifference > 0u) && ((static_cast<double>(maxTotalDifference) * maxDifferenceMultiplier) > tolerance))
+		--maxTotalDifference;
+	const std::uint32_t packedTarget{ targetPixel.getPacked() };
+	const Rect32 compactBoundary{ Rect32::narrow(boundary) };
+	std::queue<Xy32> q{}; // (half the size of a queue of Xy)
+	q.push(Xy32{ position });
 	std::size_t largestQueueSize{ 0u };
 	while (!q.empty())
 	{
-		const Xy xy{ q.front() };
+		const Xy32 xy{ q.front() };
 		q.pop();
-		if (boundary.contains(xy))
+		if (compactBoundary.contains(xy))
 		{
-			const Pixel currentPixel{ image.getPixel(xy) };
+			const Pixel currentPixel{ image.getPixel(Xy{ xy }) };
 			if (currentPixel != replacementPixel)
 			{
-				if (amountOfDifferenceBetweenTwoPixels(currentPixel, targetPixel) <= tolerance)
+				if (Pixel::getSum(Pixel::getDifference(currentPixel.getPacked(), packedTarget)) <= maxTotalDifference)
 				{
-					image.setPixel(xy, replacementPixel);
-					if (xy.x > boundary.position.x)
+					image.setPixel(Xy{ xy }, replacementPixel);
+					if (xy.x > compactBoundary.position.x)
 						q.push({ xy.x - 1u, xy.y });
-					if ((xy.x + 1u) < boundary.position.x + boundary.size.x)
+					if ((xy.x + 1u) < compactBoundary.position.x + compactBoundary.size.x)
 						q.push({ xy.x + 1u, xy.y });
-					if (xy.y > boundary.position.y)
+					if (xy.y > compactBoundary.position.y)
 						q.push({ xy.x, xy.y - 1u });
-					if ((xy.y + 1u) < boundary.position.y + boundary.size.y)
+					if ((xy.y + 1u) < compactBoundary.position.y + compactBoundary.size.y)
 						q.push({ xy.x, xy.y + 1u });
 				}
 			}
@@ -525,46 +871,41 @@ inline void Image::fill(Xy startPosition, Pixel replacementPixel, Pixel targetPi
 	priv_makeRectFullImageSizeIfHasNoSize(boundary);
 	if (!boundary.contains(startPosition))
 		return;
+	if ((startPosition.x >= m_size.x) || (startPosition.y >= m_size.y))
+		return;
+	boundary.size.x = std::min(boundary.size.x, m_size.x - boundary.position.x);
+	boundary.size.y = std::min(boundary.size.y, m_size.y - boundary.position.y);
 
+	replacementPixel = priv_getStoredPixel(replacementPixel);
 	const Xy position{ startPosition };
 	Image& image{ *this };
-	auto differenceBetweenTwoPixels = [](const Pixel& pixel, const Pixel& reference)
-	{
-		const int differenceR{ static_cast<int>(pixel.r) - static_cast<int>(reference.r) };
-		const int differenceG{ static_cast<int>(pixel.g) - static_cast<int>(reference.g) };
-		const int differenceB{ static_cast<int>(pixel.b) - static_cast<int>(reference.b) };
-		const int differenceA{ static_cast<int>(pixel.a) - static_cast<int>(reference.a) };
-		return Pixel{ static_cast<std::uint8_t>(std::abs(differenceR)), static_cast<std::uint8_t>(std::abs(differenceG)),
-			static_cast<std::uint8_t>(std::abs(differenceB)), static_cast<std::uint8_t>(std::abs(differenceA)) };
-	};
-	const bool isZeroTolerance{ (tolerance.r == 0u) && (tolerance.g == 0u) && (tolerance.b == 0u) && (tolerance.a == 0u) };
-	std::queue<Xy> q{};
-	q.push(position);
+	const std::uint32_t packedTarget{ targetPixel.getPacked() };
+	const std::uint32_t packedTolerance{ tolerance.getPacked() };
+	const bool isZeroTolerance{ packedTolerance == 0u };
+	const Rect32 compactBoundary{ Rect32::narrow(boundary) };
+	std::queue<Xy32> q{}; // (half the size of a queue of Xy)
+	q.push(Xy32{ position });
 	while (!q.empty())
 	{
-		const Xy xy{ q.front() };
+		const Xy32 xy{ q.front() };
 		q.pop();
-		if (boundary.contains(xy))
+		if (compactBoundary.contains(xy))
 		{
-			const Pixel currentPixel{ image.getPixel(xy) };
+			const Pixel currentPixel{ image.getPixel(Xy{ xy }) };
 			if (currentPixel != replacementPixel)
 			{
-				bool isToBeReplaced{ isZeroTolerance && (currentPixel == targetPixel) };
-				if (!isToBeReplaced)
-				{
-					const Pixel difference{ differenceBetweenTwoPixels(currentPixel, targetPixel) };
-					isToBeReplaced = (difference.r <= tolerance.r) && (difference.g <= tolerance.g) && (difference.b <= tolerance.b) && (difference.a <= tolerance.a);
-				}
+				const std::uint32_t packedCurrent{ currentPixel.getPacked() };
+				const bool isToBeReplaced{ isZeroTolerance ? (packedCurrent == packedTarget) : Pixel::isWithin(Pixel::getDifference(packedCurrent, packedTarget), packedTolerance) };
 				if (isToBeReplaced)
 				{
-					image.setPixel(xy, replacementPixel);
-					if (xy.x > boundary.position.x)
+					image.setPixel(Xy{ xy }, replacementPixel);
+					if (xy.x > compactBoundary.position.x)
 						q.push({ xy.x - 1u, xy.y });
-					if ((xy.x + 1u) < boundary.position.x + boundary.size.x)
+					if ((xy.x + 1u) < compactBoundary.position.x + compactBoundary.size.x)
 						q.push({ xy.x + 1u, xy.y });
-					if (xy.y > boundary.position.y)
+					if (xy.y > compactBoundary.position.y)
 						q.push({ xy.x, xy.y - 1u });
-					if ((xy.y + 1u) < boundary.position.y + boundary.size.y)
+					if ((xy.y + 1u) < compactBoundary.position.y + compactBoundary.size.y)
 						q.push({ xy.x, xy.y + 1u });
 				}
 			}
@@ -572,6 +913,42 @@ inline void Image::fill(Xy startPosition, Pixel replacementPixel, Pixel targetPi
 	}
 }
 
+inline void Image::bleedAlpha(const Rect rect)
+{
+	priv_bleedAlpha(rect);
+}
+
+inline void Image::bleedAlpha(const Atlas& atlas)
+{
+	if ((m_pixelFormat == PixelFormat::A8) || (m_pixelFormat == PixelFormat::L8) || (m_pixelFormat == PixelFormat::Indexed8))
+		return;
+
+	const std::vector<Atlas::Tile>& tiles{ atlas.constAccess() };
+	takeOwnership();
+	Parallel::forEach(tiles.size(), [&](const std::size_t i)
+	{
+		if (!priv_rectHasNoSize(tiles[i].rect))
+			priv_bleedAlpha(tiles[i].rect);
+	});
+}
+
+inline void Image::generateDistanceField(const Rect rect, const std::size_t spread, const std::uint8_t threshold, const bool isMaskFromAlpha)
+{
+	takeOwnership();
+	priv_generateDistanceField(priv_rectHasNoSize(rect) ? Rect{ { 0u, 0u }, m_size } : rect, spread, threshold, isMaskFromAlpha);
+}
+
+inline void Image::generateDistanceField(const Atlas& atlas, const std::size_t spread, const std::uint8_t threshold, const bool isMaskFromAlpha)
+{
+	const std::vector<Atlas::Tile>& tiles{ atlas.constAccess() };
+	takeOwnership();
+	Parallel::forEach(tiles.size(), [&](const std::size_t i)
+	{
+		if (!priv_rectHasNoSize(tiles[i].rect))
+			priv_generateDistanceField(tiles[i].rect, spread, threshold, isMaskFromAlpha);
+	});
+}
+
 inline void Image::processPixels(const std::function<void(Pixel&)>& pixelProcessFunction, Rect rect)
 {
 	priv_makeRectFullImageSizeIfHasNoSize(rect);
@@ -603,17 +980,82 @@ inline void Image::processPixels(const std::function<void(Pixel&, const Xy)>& pi
 	}
 }
 
+inline void Image::processPixels(const std::function<void(Pixel&)>& pixelProcessFunction, const Selection& selection)
+{
+	selection.forEachSelected([&](const Xy location)
+	{
+		if ((location.x >= m_size.x) || (location.y >= m_size.y))
+			return;
+		Pixel pixel{ getPixel(location) };
+		pixelProcessFunction(pixel);
+		setPixel(location, pixel);
+	});
+}
+
+inline Selection Image::selectColour(const Pixel pixel, const Pixel tolerance, const Rect rect) const
+{
+	const std::uint32_t packedPixel{ pixel.getPacked() };
+	const std::uint32_t packedTolerance{ tolerance.getPacked() };
+	return priv_select(rect, [packedPixel, packedTolerance](const Pixel& other) { return Pixel::isWithin(Pixel::getDifference(other.getPacked(), packedPixel), packedTolerance); });
+}
+
+inline Selection Image::selectFill(const Xy startPosition, const Pixel tolerance, Rect boundary) const
+{
+	Selection selection{ m_size };
+	priv_makeRectFullImageSizeIfHasNoSize(boundary);
+	if (!boundary.contains(startPosition) || (startPosition.x >= m_size.x) || (startPosition.y >= m_size.y))
+		return selection;
+	boundary.size.x = std::min(boundary.size.x, m_size.x - boundary.position.x);
+	boundary.size.y = std::min(boundary.size.y, m_size.y - boundary.position.y);
+
+	// four-way breadth-first search from the start, as fill. visited pixels are marked so that each is tested once
+	const std::uint32_t packedTarget{ getPixel(startPosition).getPacked() };
+	const std::uint32_t packedTolerance{ tolerance.getPacked() };
+	auto isWithinTolerance = [&](const Pixel& other) { return Pixel::isWithin(Pixel::getDifference(other.getPacked(), packedTarget), packedTolerance); };
+	Selection isVisited{ m_size };
+	const Rect32 compactBoundary{ Rect32::narrow(boundary) };
+	std::vector<Xy32> queue{ Xy32{ startPosition } };
+	isVisited.set(startPosition);
+	for (std::size_t front{ 0u }; front < queue.size(); ++front)
+	{
+		const Xy32 xy{ queue[front] };
+		if (!isWithinTolerance(getPixel(Xy{ xy })))
+			continue;
+		selection.set(Xy{ xy });
+		auto visit = [&](const Xy32 neighbour)
+		{
+			if (!isVisited.get(Xy{ neighbour }))
+			{
+				isVisited.set(Xy{ neighbour });
+				queue.push_back(neighbour);
+			}
+		};
+		if (xy.x > compactBoundary.position.x)
+			visit({ xy.x - 1u, xy.y });
+		if ((xy.x + 1u) < (compactBoundary.position.x + compactBoundary.size.x))
+			visit({ xy.x + 1u, xy.y });
+		if (xy.y > compactBoundary.position.y)
+			visit({ xy.x, xy.y - 1u });
+		if ((xy.y + 1u) < (compactBoundary.position.y + compactBoundary.size.y))
+			visit({ xy.x, xy.y + 1u });
+	}
+	return selection;
+}
+
+inline Selection Image::selectAlpha(const std::uint8_t threshold, const Rect rect) const
+{
+	return priv_select(rect, [threshold](const Pixel& pixel) { return (pixel.a >= threshold); });
+}
+
 inline void Image::expand(const Atlas& atlas, const std::size_t expansion)
 {
-	const std::size_t atlasSize{ atlas.getSize() };
-	for (std::size_t i{ 0u }; i < atlasSize; ++i)
+	for (const std::size_t i : atlas.getBlitOrder())
 		expand(atlas.get(i).rect, expansion);
 }
 
 inline void Image::expand(Atlas& atlas, const bool expandAtlasTiles, const std::size_t expansion)
 {
-	const std::size_t atlasSize{ atlas.getSize() };
-	for (std::size_t i{ 0u }; i < atlasSize; ++i)
+	for (const std::size_t i : atlas.getBlitOrder())
 	{
 		const Rect expandedRect{ expand(atlas.get(i).rect, expansion) };
 		if (expandAtlasTiles)
@@ -628,17 +1070,110 @@ inline bool Image::transfer(Atlas& atlas, const Image& sourceImage, const Atlas&
 	if (atlasSize != sourceAtlasSize)
 		return false;
 
-	for (std::size_t i{ 0u }; i < atlasSize; ++i)
-		copy(atlas.get(i).rect.position, sourceImage, sourceAtlas.get(i).rect, amountOfExpansionIncluded);
-	return true;
+	std::vector<SourceTile> sourceTiles(sourceAtlasSize);
+	for (std::size_t i{ 0u }; i < sourceAtlasSize; ++i)
+		sourceTiles[i] = { &sourceImage, sourceAtlas.get(i).rect };
+	return compose(atlas, sourceTiles, amountOfExpansionIncluded);
 }
 
-inline void Image::trimAtlas(Atlas& atlas, const Pixel pixelToTrim) const
+inline bool Image::transfer(const Atlas& atlas, const Image& sourceImage, const Atlas& sourceAtlas, const BlendMode blendMode, const bool isPremultiplied)
 {
-	const std::size_t numberOfTiles{ atlas.getSize() };
-	for (std::size_t tileIndex{ 0u }; tileIndex < numberOfTiles; ++tileIndex)
-	{
-		Atlas::Tile tile{ atlas.get(tileIndex) };
+	const std::size_t atlasSize{ atlas.getSize() };
+	if (atlasSize != sourceAtlas.getSize())
+		return false;
+
+	const std::vector<Atlas::Tile>& tiles{ atlas.constAccess() };
+	const std::vector<Atlas::Tile>& sourceTiles{ sourceAtlas.constAccess() };
+	const std::vector<std::size_t> order{ atlas.getBlitOrder(sourceAtlas) };
+
+	// a source within this image is copied out (by blend) for each tile in turn
+	if (&sourceImage == this)
+	{
+		for (const std::size_t i : order)
+		{
+			if (!priv_rectHasNoSize(sourceTiles[i].rect))
+				blend(tiles[i].rect.position, sourceImage, sourceTiles[i].rect, blendMode, isPremultiplied);
+		}
+		return true;
+	}
+
+	// tiles are blended in parallel (rather than the rows of each tile) so that small tiles are not each split across threads
+	takeOwnership();
+	Parallel::forEach(atlasSize, [&](const std::size_t orderIndex)
+	{
+		const std::size_t i{ order[orderIndex] };
+		const Xy position{ tiles[i].rect.position };
+		Rect sourceRect{ sourceTiles[i].rect };
+		if (!priv_rectHasNoSize(sourceRect) && priv_clipSourceRect(position, sourceImage, sourceRect))
+			priv_blendRows(position, sourceImage, sourceRect, blendMode, isPremultiplied);
+	});
+	return true;
+}
+
+inline bool Image::compose(const Atlas& atlas, const std::vector<SourceTile>& sourceTiles, const std::size_t amountOfExpansionIncluded)
+{
+	const std::size_t atlasSize{ atlas.getSize() };
+	if (atlasSize != sourceTiles.size())
+		return false;
+
+	// visit the destination tiles in an order that keeps both writes and reads close together
+	Atlas sourceAtlas{};
+	sourceAtlas.resize(atlasSize);
+	for (std::size_t i{ 0u }; i < atlasSize; ++i)
+		sourceAtlas.access(i).rect = sourceTiles[i].rect;
+	const std::vector<std::size_t> order{ atlas.getBlitOrder(sourceAtlas) };
+
+	const std::vector<Atlas::Tile>& tiles{ atlas.constAccess() };
+	auto composeTile = [&](const std::size_t orderIndex)
+	{
+		const std::size_t i{ order[orderIndex] };
+		const SourceTile& sourceTile{ sourceTiles[i] };
+		if (sourceTile.image != nullptr)
+			copy(tiles[i].rect.position, *sourceTile.image, sourceTile.rect, amountOfExpansionIncluded);
+	};
+
+	// destination tiles are independent unless this image is also one of the sources
+	const bool isThisImageASource{ std::any_of(sourceTiles.begin(), sourceTiles.end(), [this](const SourceTile& sourceTile) { return (sourceTile.image == this); }) };
+	if (isThisImageASource)
+	{
+		for (std::size_t i{ 0u }; i < atlasSize; ++i)
+			composeTile(i);
+	}
+	else
+	{
+		takeOwnership();
+		Parallel::forEach(atlasSize, composeTile);
+	}
+	return true;
+}
+
+inline void Image::trimAtlas(Atlas& atlas, const Pixel pixelToTrim) const
+{
+	// pixels are compared in the image's own format when the format can store pixelToTrim exactly. otherwise (e.g. L8 or Indexed8) encoding it would match other pixels so decoded pixels are compared instead
+	const bool isStoredExactly{ priv_getStoredPixel(pixelToTrim) == pixelToTrim };
+	std::array<std::uint8_t, 4u> trimData{};
+	priv_encodePixel(trimData.data(), pixelToTrim);
+	std::uint32_t trimWord{ 0u };
+	std::memcpy(&trimWord, trimData.data(), 4u);
+	auto isContent = [&](const Xy location)
+	{
+		if ((location.x >= m_size.x) || (location.y >= m_size.y))
+			return (Pixel{} != pixelToTrim);
+		if (!isStoredExactly)
+			return (priv_decodePixel(priv_getPixelData(location)) != pixelToTrim);
+		if (m_numberOfValuesPerPixel == 4u)
+		{
+			std::uint32_t word{ 0u };
+			std::memcpy(&word, priv_getPixelData(location), 4u);
+			return (word != trimWord);
+		}
+		return (std::memcmp(priv_getPixelData(location), trimData.data(), m_numberOfValuesPerPixel) != 0);
+	};
+
+	const std::size_t numberOfTiles{ atlas.getSize() };
+	for (std::size_t tileIndex{ 0u }; tileIndex < numberOfTiles; ++tileIndex)
+	{
+		Atlas::Tile tile{ atlas.get(tileIndex) };
 
 		if ((tile.rect.size.x == 0u) || (tile.rect.size.y == 0u))
 		{
@@ -658,7 +1193,7 @@ inline void Image::trimAtlas(Atlas& atlas, const Pixel pixelToTrim) const
 		{
 			for (std::size_t x{ 0u }; x < tile.rect.size.x; ++x)
 			{
-				if (getPixel({ tile.rect.position.x + x, tile.rect.position.y + y }) != pixelToTrim)
+				if (isContent({ tile.rect.position.x + x, tile.rect.position.y + y }))
 				{
 					tile.offset.y = y;
 					tile.rect.position.y += y;
@@ -683,7 +1218,7 @@ inline void Image::trimAtlas(Atlas& atlas, const Pixel pixelToTrim) const
 		{
 			for (std::size_t x{ 0u }; x < tile.rect.size.x; ++x)
 			{
-				if (getPixel({ tile.rect.position.x + x, tile.rect.position.y + tile.rect.size.y - y - 1u }) != pixelToTrim)
+				if (isContent({ tile.rect.position.x + x, tile.rect.position.y + tile.rect.size.y - y - 1u }))
 				{
 					tile.rect.size.y -= y;
 					goto endloopTrimBottom;
@@ -697,7 +1232,7 @@ inline void Image::trimAtlas(Atlas& atlas, const Pixel pixelToTrim) const
 		{
 			for (std::size_t y{ 0u }; y < tile.rect.size.y; ++y)
 			{
-				if (getPixel({ tile.rect.position.x + x, tile.rect.position.y + y }) != pixelToTrim)
+				if (isContent({ tile.rect.position.x + x, tile.rect.position.y + y }))
 				{
 					tile.offset.x = x;
 					tile.rect.position.x += x;
@@ -713,7 +1248,7 @@ inline void Image::trimAtlas(Atlas& atlas, const Pixel pixelToTrim) const
 		{
 			for (std::size_t y{ 0u }; y < tile.rect.size.y; ++y)
 			{
-				if (getPixel({ tile.rect.position.x + tile.rect.size.x - x - 1u, tile.rect.position.y + y }) != pixelToTrim)
+				if (isContent({ tile.rect.position.x + tile.rect.size.x - x - 1u, tile.rect.position.y + y }))
 				{
 					tile.rect.size.x -= x;
 					goto endloopTrimRight;
@@ -775,261 +1310,866 @@ inline Xy Image::separateGridTiles(
 	const bool emptyOrig,
 	const Pixel emptyPixel)
 {
-	if ((expansion * 2u) > separation.x)
-		expansion = separation.x / 2u;
-	if ((expansion * 2u) > separation.y)
-		expansion = separation.y / 2u;
-	if (separation.x < origSeparation.x)
-		separation.x = origSeparation.x;
-	if (separation.y < origSeparation.y)
-		separation.y = origSeparation.y;
+	if (!priv_separateGridTiles(startPosition, offset, gridSize, tileSize, separation, expansion, origSeparation, emptyOrig, emptyPixel))
+		return {};
 
-	const Xy origGridSize{ gridSize.x * (tileSize.x + origSeparation.x) - origSeparation.x, gridSize.y * (tileSize.y + origSeparation.y) - origSeparation.y };
 	const Xy gridSizeRequired{ gridSize.x * (tileSize.x + separation.x) - separation.x + (expansion * 2u), gridSize.y * (tileSize.y + separation.y) - separation.y + (expansion * 2u) };
+	return { startPosition.x + offset.x + gridSizeRequired.x, startPosition.y + offset.y + gridSizeRequired.y };
+}
 
-	if ((startPosition.x + offset.x + gridSizeRequired.x) > m_size.x)
-		return {};
-	if ((startPosition.y + offset.y + gridSizeRequired.y) > m_size.y)
+inline Atlas Image::separateGridTilesReturnAtlas(
+	const Xy startPosition,
+	const Xy offset,
+	const Xy gridSize,
+	const Xy tileSize,
+	Xy separation,
+	std::size_t expansion,
+	const Xy origSeparation,
+	const bool emptyOrig,
+	const Pixel emptyPixel,
+	const std::size_t category,
+	const std::size_t initId)
+{
+	if (!priv_separateGridTiles(startPosition, offset, gridSize, tileSize, separation, expansion, origSeparation, emptyOrig, emptyPixel))
 		return {};
 
-	struct CopyRect
+	// expanded tiles are the tiles of a grid with the expansion taken out of the separation
+	const std::size_t doubleExpansion{ expansion * 2u };
+	Atlas atlas{};
+	atlas.generateFromGrid(startPosition + offset, gridSize, tileSize + Xy{ doubleExpansion, doubleExpansion }, separation - Xy{ doubleExpansion, doubleExpansion }, category, initId);
+	return atlas;
+}
+
+inline const std::uint8_t* Image::getData() const
+{
+	if ((m_size.x == 0u) || (m_size.y == 0u))
+		throw Exception("Cannot get data for an empty image.");
+
+	return priv_getData();
+}
+
+inline const std::uint8_t* Image::getRowData(const std::size_t y) const
+{
+	assert(y < m_size.y);
+	if (y >= m_size.y)
+		throw Exception("Cannot get row data: invalid row.");
+
+	return priv_getData() + (y * m_rowStride);
+}
+
+inline std::uint8_t* Image::accessRowData(const std::size_t y)
+{
+	assert(y < m_size.y);
+	if (y >= m_size.y)
+		throw Exception("Cannot access row data: invalid row.");
+
+	return priv_getMutableData() + (y * m_rowStride);
+}
+
+inline bool Image::priv_isValidIndex(const std::size_t index) const
+{
+	return (index < (m_size.x * m_size.y));
+}
+
+inline std::size_t Image::priv_getIndexFromLocation(const Xy location) const
+{
+	const std::size_t outOfBoundsIndex{ m_size.x * m_size.y };
+	if ((location.x >= m_size.x) || (location.y >= m_size.y))
+		return outOfBoundsIndex;
+	return (location.y * m_size.x) + location.x;
+}
+
+inline std::size_t Image::priv_getDataIndex(const std::size_t index) const
+{
+	const std::size_t rowSize{ m_size.x * m_numberOfValuesPerPixel };
+	if (m_rowStride == rowSize)
+		return index * m_numberOfValuesPerPixel;
+	return ((index / m_size.x) * m_rowStride) + ((index % m_size.x) * m_numberOfValuesPerPixel);
+}
+
+inline std::size_t Image::priv_getRowStride(const std::size_t width) const
+{
+	const std::size_t rowSize{ width * m_numberOfValuesPerPixel };
+	return ((rowSize + m_rowAlignment - 1u) / m_rowAlignment) * m_rowAlignment;
+}
+
+inline AlignedBuffer Image::priv_acquireBuffer(const std::size_t size)
+{
+	if (m_scratchPool != nullptr)
+		return m_scratchPool->acquire(size);
+	return AlignedBuffer(size);
+}
+
+inline void Image::priv_releaseBuffer(AlignedBuffer&& buffer)
+{
+	if (m_scratchPool != nullptr)
+		m_scratchPool->release(std::move(buffer));
+}
+
+inline void Image::priv_setPixel(const std::size_t index, const Pixel& pixel)
+{
+	assert(priv_isValidIndex(index));
+
+	priv_encodePixel(priv_getMutableData() + priv_getDataIndex(index), pixel);
+}
+
+inline Pixel Image::priv_getPixel(const std::size_t index) const
+{
+	assert(priv_isValidIndex(index));
+
+	return priv_decodePixel(priv_getData() + priv_getDataIndex(index));
+}
+
+inline void Image::priv_encodePixel(std::uint8_t* data, const Pixel& pixel) const
+{
+	switch (m_pixelFormat)
 	{
-		Rect source;
-		Rect expanded;
-	};
-	std::vector<CopyRect> tileRects(gridSize.x * gridSize.y);
-	for (std::size_t y{ 0u }; y < gridSize.y; ++y)
+	case PixelFormat::RGBA:
+		data[0u] = pixel.r;
+		data[1u] = pixel.g;
+		data[2u] = pixel.b;
+		data[3u] = pixel.a;
+		break;
+	case PixelFormat::BGRA:
+		data[0u] = pixel.b;
+		data[1u] = pixel.g;
+		data[2u] = pixel.r;
+		data[3u] = pixel.a;
+		break;
+	case PixelFormat::A8:
+		data[0u] = pixel.a;
+		break;
+	case PixelFormat::L8:
+	case PixelFormat::LA8:
+		// luminance weights (sum to 256) are approximately Rec. 601
+		data[0u] = static_cast<std::uint8_t>(((pixel.r * 77u) + (pixel.g * 150u) + (pixel.b * 29u) + 128u) >> 8u);
+		if (m_pixelFormat == PixelFormat::LA8)
+			data[1u] = pixel.a;
+		break;
+	case PixelFormat::Indexed8:
+		data[0u] = priv_getNearestPaletteIndex(pixel);
+		break;
+	}
+}
+
+inline Pixel Image::priv_decodePixel(const std::uint8_t* data) const
+{
+	switch (m_pixelFormat)
 	{
-		for (std::size_t x{ 0u }; x < gridSize.x; ++x)
+	case PixelFormat::RGBA:
+		return { data[0u], data[1u], data[2u], data[3u] };
+	case PixelFormat::BGRA:
+		return { data[2u], data[1u], data[0u], data[3u] };
+	case PixelFormat::A8:
+		return { 255u, 255u, 255u, data[0u] };
+	case PixelFormat::L8:
+		return { data[0u], data[0u], data[0u], 255u };
+	case PixelFormat::LA8:
+		return { data[0u], data[0u], data[0u], data[1u] };
+	case PixelFormat::Indexed8:
+		return (data[0u] < m_palette.size()) ? m_palette[data[0u]] : Pixel{ 0u, 0u, 0u, 0u };
+	}
+	return {};
+}
+
+inline Pixel Image::priv_getStoredPixel(const Pixel& pixel) const
+{
+	// the pixel as it reads back after being written in this image's format
+	std::array<std::uint8_t, 4u> data{};
+	priv_encodePixel(data.data(), pixel);
+	return priv_decodePixel(data.data());
+}
+
+inline std::uint8_t Image::priv_getNearestPaletteIndex(const Pixel& pixel) const
+{
+	std::size_t nearestIndex{ 0u };
+	std::size_t nearestDistance{ std::numeric_limits<std::size_t>::max() };
+	const std::size_t paletteSize{ m_palette.size() };
+	for (std::size_t i{ 0u }; i < paletteSize; ++i)
+	{
+		const Pixel& colour{ m_palette[i] };
+		const int differenceR{ static_cast<int>(pixel.r) - static_cast<int>(colour.r) };
+		const int differenceG{ static_cast<int>(pixel.g) - static_cast<int>(colour.g) };
+		const int differenceB{ static_cast<int>(pixel.b) - static_cast<int>(colour.b) };
+		const int differenceA{ static_cast<int>(pixel.a) - static_cast<int>(colour.a) };
+		const std::size_t distance{ static_cast<std::size_t>((differenceR * differenceR) + (differenceG * differenceG) + (differenceB * differenceB) + (differenceA * differenceA)) };
+		if (distance < nearestDistance)
 		{
-			Rect& sourceRect{ tileRects[y * gridSize.x + x].source };
-			Rect& expandedRect{ tileRects[y * gridSize.x + x].expanded };
+			nearestIndex = i;
+			nearestDistance = distance;
+			if (distance == 0u)
+				break;
+		}
+	}
+	return static_cast<std::uint8_t>(nearestIndex);
+}
+
+inline std::uint8_t* Image::priv_getPixelData(const Xy location)
+{
+	assert((location.x < m_size.x) && (location.y < m_size.y));
+
+	return priv_getMutableData() + ((location.y * m_rowStride) + (location.x * m_numberOfValuesPerPixel));
+}
+
+inline const std::uint8_t* Image::priv_getPixelData(const Xy location) const
+{
+	assert((location.x < m_size.x) && (location.y < m_size.y));
+
+	return priv_getData() + ((location.y * m_rowStride) + (location.x * m_numberOfValuesPerPixel));
+}
 
-			sourceRect.size = tileSize;
-			expandedRect.size = { tileSize.x + (expansion * 2u), tileSize.y + (expansion * 2u) };
-			sourceRect.position = { startPosition.x + (x * (tileSize.x + origSeparation.x)), startPosition.y + (y * (tileSize.y + origSeparation.y)) };
-			expandedRect.position = { startPosition.x + offset.x + (x * (tileSize.x + separation.x)), startPosition.y + offset.y + (y * (tileSize.y + separation.y)) };
+inline void Image::priv_allocate(const Xy size)
+{
+	// the content is unspecified afterwards
+	priv_dropView();
+	const std::size_t rowStride{ priv_getRowStride(size.x) };
+	const std::size_t dataSize{ rowStride * size.y };
+	if (dataSize != m_data.size())
+	{
+		if ((dataSize > m_data.capacity()) && (m_scratchPool != nullptr))
+		{
+			AlignedBuffer data{ priv_acquireBuffer(dataSize) };
+			m_data.swap(data);
+			priv_releaseBuffer(std::move(data));
 		}
+		else
+			m_data.resize(dataSize);
+	}
+	m_size = size;
+	m_rowStride = rowStride;
+}
+
+inline const std::uint8_t* Image::priv_getData() const
+{
+	return (m_viewData != nullptr) ? m_viewData : m_data.data();
+}
+
+inline std::uint8_t* Image::priv_getMutableData()
+{
+	if (m_viewData != nullptr)
+	{
+		// copy-on-write: the viewed data is copied (with this image's own row stride) into the image's data and the view is dropped
+		const std::size_t rowStride{ priv_getRowStride(m_size.x) };
+		const std::size_t rowSize{ m_size.x * m_numberOfValuesPerPixel };
+		AlignedBuffer data{ priv_acquireBuffer(rowStride * m_size.y) };
+		for (std::size_t y{ 0u }; y < m_size.y; ++y)
+			std::memcpy(data.data() + (y * rowStride), m_viewData + (y * m_rowStride), rowSize);
+		m_data.swap(data);
+		priv_releaseBuffer(std::move(data));
+		m_rowStride = rowStride;
+		priv_dropView();
 	}
-	for (std::size_t yCounter{ 0u }; yCounter < gridSizeRequired.y; ++yCounter)
+	return m_data.data();
+}
+
+inline void Image::priv_dropView()
+{
+	m_viewData = nullptr;
+	m_viewDataOwner.reset();
+}
+
+inline void Image::priv_copyPixels(std::uint8_t* destination, const Image& sourceImage, const std::uint8_t* source, const std::size_t numberOfPixels)
+{
+	const bool isSameFormat{ (sourceImage.m_pixelFormat == m_pixelFormat) && ((m_pixelFormat != PixelFormat::Indexed8) || (sourceImage.m_palette == m_palette)) };
+	if (isSameFormat)
 	{
-		const std::size_t y{ startPosition.y + offset.y + gridSizeRequired.y - yCounter - 1u };
-		for (std::size_t xCounter{ 0u }; xCounter < gridSizeRequired.x; ++xCounter)
+		std::memmove(destination, source, numberOfPixels * m_numberOfValuesPerPixel);
+		return;
+	}
+
+	// RGBA <-> BGRA: swap red and blue while copying
+	if ((m_numberOfValuesPerPixel == 4u) && (sourceImage.m_numberOfValuesPerPixel == 4u))
+	{
+		for (std::size_t i{ 0u }; i < numberOfPixels; ++i)
 		{
-			const std::size_t x{ startPosition.x + offset.x + gridSizeRequired.x - xCounter - 1u };
+			const std::size_t dataIndex{ i * 4u };
+			destination[dataIndex + 0u] = source[dataIndex + 2u];
+			destination[dataIndex + 1u] = source[dataIndex + 1u];
+			destination[dataIndex + 2u] = source[dataIndex + 0u];
+			destination[dataIndex + 3u] = source[dataIndex + 3u];
+		}
+		return;
+	}
 
-			bool isClearPixel{ true };
+	// alpha only from 32-bit colour: take the alpha bytes
+	if ((m_pixelFormat == PixelFormat::A8) && (sourceImage.m_numberOfValuesPerPixel == 4u))
+	{
+		for (std::size_t i{ 0u }; i < numberOfPixels; ++i)
+			destination[i] = source[(i * 4u) + 3u];
+		return;
+	}
 
-			for (const auto& rects : tileRects)
-			{
-				if (rects.expanded.contains({ x, y }))
-				{
-					isClearPixel = false;
-
-					Xy local{ x - rects.expanded.position.x, y - rects.expanded.position.y };
-					Xy uv{};
-					if (local.x < expansion)
-						uv.x = 0u;
-					else if (local.x >= (tileSize.x + expansion))
-						uv.x = tileSize.x - 1u;
-					else
-						uv.x = local.x - expansion;
-					if (local.y < expansion)
-						uv.y = 0u;
-					else if (local.y >= (tileSize.y + expansion))
-						uv.y = tileSize.y - 1u;
-					else
-						uv.y = local.y - expansion;
-
-					uv.x += rects.source.position.x;
-					uv.y += rects.source.position.y;
-
-					setPixel({ x, y }, getPixel(uv));
-					break;
-				}
-			}
-			if (isClearPixel)
-				setPixel({ x, y }, emptyPixel);
+	// any other conversion goes through Pixel
+	const std::size_t sourceNumberOfValuesPerPixel{ sourceImage.m_numberOfValuesPerPixel };
+	for (std::size_t i{ 0u }; i < numberOfPixels; ++i)
+		priv_encodePixel(destination + (i * m_numberOfValuesPerPixel), sourceImage.priv_decodePixel(source + (i * sourceNumberOfValuesPerPixel)));
+}
+
+inline void Image::priv_splatPixel(std::uint8_t* destination, const std::uint8_t* pixelData, const std::size_t numberOfPixels)
+{
+	switch (m_numberOfValuesPerPixel)
+	{
+	case 1u:
+		std::memset(destination, pixelData[0u], numberOfPixels);
+		break;
+	case 2u:
+		{
+			std::uint16_t value{};
+			std::memcpy(&value, pixelData, 2u);
+			for (std::size_t i{ 0u }; i < numberOfPixels; ++i)
+				std::memcpy(destination + (i * 2u), &value, 2u);
 		}
+		break;
+	default:
+		{
+			std::uint32_t value{};
+			std::memcpy(&value, pixelData, 4u);
+			for (std::size_t i{ 0u }; i < numberOfPixels; ++i)
+				std::memcpy(destination + (i * 4u), &value, 4u);
+		}
+		break;
 	}
-	if (emptyOrig)
+}
+
+inline bool Image::priv_clipSourceRect(const Xy position, const Image& sourceImage, Rect& sourceRect) const
+{
+	// the source rect must be within the source image. parts of it that would land outside of this image are dropped
+	const Xy sourceImageSize{ sourceImage.getSize() };
+	if ((sourceRect.position.x >= sourceImageSize.x) ||
+		(sourceRect.position.y >= sourceImageSize.y) ||
+		((sourceRect.position.x + sourceRect.size.x) > sourceImageSize.x) ||
+		((sourceRect.position.y + sourceRect.size.y) > sourceImageSize.y))
+		return false;
+	if ((position.x >= m_size.x) || (position.y >= m_size.y))
+		return false;
+
+	sourceRect.size.x = std::min(sourceRect.size.x, m_size.x - position.x);
+	sourceRect.size.y = std::min(sourceRect.size.y, m_size.y - position.y);
+	return true;
+}
+
+inline void Image::priv_copyRows(const Xy position, const Image& sourceImage, const Rect sourceRect)
+{
+	// both rects must be valid for their images. rows are copied bottom-up when copying downwards within the same image so that overlapping rows are read before they are overwritten
+	const bool isReversed{ (&sourceImage == this) && (position.y > sourceRect.position.y) };
+	if (&sourceImage == this)
+		takeOwnership(); // (before any source row is found: copy-on-write would release viewed data while it is being read)
+	for (std::size_t i{ 0u }; i < sourceRect.size.y; ++i)
 	{
-		for (std::size_t y{ 0u }; y < origGridSize.y; ++y)
+		const std::size_t y{ isReversed ? (sourceRect.size.y - i - 1u) : i };
+		priv_copyPixels(priv_getPixelData({ position.x, position.y + y }), sourceImage, sourceImage.priv_getPixelData({ sourceRect.position.x, sourceRect.position.y + y }), sourceRect.size.x);
+	}
+}
+
+inline Selection Image::priv_select(Rect rect, const std::function<bool(const Pixel&)>& isSelected) const
+{
+	Selection selection{ m_size };
+	priv_makeRectFullImageSizeIfHasNoSize(rect);
+	if ((rect.position.x >= m_size.x) || (rect.position.y >= m_size.y))
+		return selection;
+	rect.size.x = std::min(rect.size.x, m_size.x - rect.position.x);
+	rect.size.y = std::min(rect.size.y, m_size.y - rect.position.y);
+
+	// each row has its own words so rows can be tested in parallel. bits are gathered into a word before it is stored
+	Parallel::forEach(rect.size.y, [&](const std::size_t y)
+	{
+		const std::size_t locationY{ rect.position.y + y };
+		const std::uint8_t* data{ priv_getPixelData({ rect.position.x, locationY }) };
+		std::uint64_t* words{ selection.accessRowWords(locationY) };
+		std::uint64_t word{ 0u };
+		for (std::size_t x{ 0u }; x < rect.size.x; ++x)
 		{
-			for (std::size_t x{ 0u }; x < origGridSize.x; ++x)
+			const std::size_t locationX{ rect.position.x + x };
+			if (isSelected(priv_decodePixel(data + (x * m_numberOfValuesPerPixel))))
+				word |= std::uint64_t{ 1u } << (locationX % 64u);
+			if (((locationX % 64u) == 63u) || ((x + 1u) == rect.size.x))
 			{
-				if ((x >= offset.x) && (y >= offset.y))
-					continue;
-				setPixel({ x, y }, emptyPixel);
+				words[locationX / 64u] = word;
+				word = 0u;
 			}
 		}
-	}
-	return { startPosition.x + offset.x + gridSizeRequired.x, startPosition.y + offset.y + gridSizeRequired.y };
+	});
+	return selection;
 }
 
-inline Atlas Image::separateGridTilesReturnAtlas(
-	const Xy startPosition,
-	const Xy offset,
-	const Xy gridSize,
-	const Xy tileSize,
-	Xy separation,
-	std::size_t expansion,
-	const Xy origSeparation,
-	const bool emptyOrig,
-	const Pixel emptyPixel,
-	const std::size_t category,
-	const std::size_t initId)
+inline void Image::priv_replacePixels(const std::vector<std::pair<Pixel, Pixel>>& replacements, const std::vector<Rect>& rects)
 {
-	if ((expansion * 2u) > separation.x)
-		expansion = separation.x / 2u;
-	if ((expansion * 2u) > separation.y)
-		expansion = separation.y / 2u;
-	if (separation.x < origSeparation.x)
-		separation.x = origSeparation.x;
-	if (separation.y < origSeparation.y)
-		separation.y = origSeparation.y;
+	if (replacements.empty())
+		return;
 
-	const Xy origGridSize{ gridSize.x * (tileSize.x + origSeparation.x) - origSeparation.x, gridSize.y * (tileSize.y + origSeparation.y) - origSeparation.y };
-	const Xy gridSizeRequired{ gridSize.x * (tileSize.x + separation.x) - separation.x + (expansion * 2u), gridSize.y * (tileSize.y + separation.y) - separation.y + (expansion * 2u) };
+	// single-byte formats: a table of every stored value
+	if (m_numberOfValuesPerPixel == 1u)
+	{
+		ColourMap<Pixel> newPixels(replacements.size());
+		for (auto it{ replacements.rbegin() }; it != replacements.rend(); ++it)
+			newPixels[ColourMap<Pixel>::getKey(it->first)] = it->second;
+		std::array<std::uint8_t, 256u> table{};
+		for (std::size_t value{ 0u }; value < 256u; ++value)
+		{
+			const std::uint8_t storedValue{ static_cast<std::uint8_t>(value) };
+			table[value] = storedValue;
+			const Pixel* newPixel{ newPixels.find(ColourMap<Pixel>::getKey(priv_decodePixel(&storedValue))) };
+			if (newPixel != nullptr)
+				priv_encodePixel(&table[value], *newPixel);
+		}
+		priv_forEachRow(rects, [&table](std::uint8_t* data, const std::size_t numberOfPixels)
+		{
+			for (std::size_t i{ 0u }; i < numberOfPixels; ++i)
+				data[i] = table[data[i]];
+		});
+		return;
+	}
 
-	if ((startPosition.x + offset.x + gridSizeRequired.x) > m_size.x)
-		return {};
-	if ((startPosition.y + offset.y + gridSizeRequired.y) > m_size.y)
-		return {};
+	// otherwise the stored bytes are looked up. originals that cannot be stored exactly never match a pixel
+	ColourMap<std::uint32_t> newValues(replacements.size());
+	for (auto it{ replacements.rbegin() }; it != replacements.rend(); ++it)
+	{
+		if (!(priv_getStoredPixel(it->first) == it->first))
+			continue;
+		std::uint32_t originalValue{ 0u };
+		std::uint32_t newValue{ 0u };
+		priv_encodePixel(reinterpret_cast<std::uint8_t*>(&originalValue), it->first);
+		priv_encodePixel(reinterpret_cast<std::uint8_t*>(&newValue), it->second);
+		newValues[originalValue] = newValue;
+	}
+	if (newValues.getSize() == 0u)
+		return;
+	const std::size_t numberOfValuesPerPixel{ m_numberOfValuesPerPixel };
+	priv_forEachRow(rects, [&newValues, numberOfValuesPerPixel](std::uint8_t* data, const std::size_t numberOfPixels)
+	{
+		for (std::size_t i{ 0u }; i < numberOfPixels; ++i)
+		{
+			std::uint8_t* pixelData{ data + (i * numberOfValuesPerPixel) };
+			std::uint32_t value{ 0u };
+			std::memcpy(&value, pixelData, numberOfValuesPerPixel);
+			const std::uint32_t* newValue{ newValues.find(value) };
+			if (newValue != nullptr)
+				std::memcpy(pixelData, newValue, numberOfValuesPerPixel);
+		}
+	});
+}
+
+inline void Image::priv_forEachRow(const std::vector<Rect>& rects, const std::function<void(std::uint8_t*, std::size_t)>& rowFunction)
+{
+	std::vector<Rect> rows{};
+	for (const Rect& rect : rects)
+	{
+		if ((rect.position.x >= m_size.x) || (rect.position.y >= m_size.y))
+			continue;
+		const Xy size{ std::min(rect.size.x, m_size.x - rect.position.x), std::min(rect.size.y, m_size.y - rect.position.y) };
+		for (std::size_t y{ 0u }; (size.x > 0u) && (y < size.y); ++y)
+			rows.push_back({ { rect.position.x, rect.position.y + y }, { size.x, 1u } });
+	}
+	if (rows.empty())
+		return;
 
-	struct CopyRect
+	takeOwnership();
+	Parallel::forEach(rows.size(), [&](const std::size_t i)
 	{
-		Rect source;
-		Rect expanded;
-	};
-	std::vector<CopyRect> tileRects(gridSize.x * gridSize.y);
-	for (std::size_t y{ 0u }; y < gridSize.y; ++y)
+		rowFunction(priv_getPixelData(rows[i].position), rows[i].size.x);
+	});
+}
+
+inline void Image::priv_blendRows(const Xy position, const Image& sourceImage, const Rect sourceRect, const BlendMode blendMode, const bool isPremultiplied)
+{
+	// both rects must be valid for their images and must not overlap. 32-bit formats are blended in place (swapping red and blue from the other 32-bit order); others go through Pixel
+	const bool isDirect{ (m_numberOfValuesPerPixel == 4u) && (sourceImage.m_numberOfValuesPerPixel == 4u) };
+	const bool isSwapped{ sourceImage.m_pixelFormat != m_pixelFormat };
+	for (std::size_t y{ 0u }; y < sourceRect.size.y; ++y)
 	{
-		for (std::size_t x{ 0u }; x < gridSize.x; ++x)
+		std::uint8_t* destination{ priv_getPixelData({ position.x, position.y + y }) };
+		const std::uint8_t* source{ sourceImage.priv_getPixelData({ sourceRect.position.x, sourceRect.position.y + y }) };
+		for (std::size_t x{ 0u }; x < sourceRect.size.x; ++x)
 		{
-			Rect& sourceRect{ tileRects[y * gridSize.x + x].source };
-			Rect& expandedRect{ tileRects[y * gridSize.x + x].expanded };
+			if (isDirect)
+			{
+				const std::uint8_t* sourcePixel{ source + (x * 4u) };
+				if (isSwapped)
+				{
+					const std::array<std::uint8_t, 4u> swapped{ sourcePixel[2u], sourcePixel[1u], sourcePixel[0u], sourcePixel[3u] };
+					priv_blendPixel(destination + (x * 4u), swapped.data(), blendMode, isPremultiplied);
+				}
+				else
+					priv_blendPixel(destination + (x * 4u), sourcePixel, blendMode, isPremultiplied);
+				continue;
+			}
 
-			sourceRect.size = tileSize;
-			expandedRect.size = { tileSize.x + (expansion * 2u), tileSize.y + (expansion * 2u) };
-			sourceRect.position = { startPosition.x + (x * (tileSize.x + origSeparation.x)), startPosition.y + (y * (tileSize.y + origSeparation.y)) };
-			expandedRect.position = { startPosition.x + offset.x + (x * (tileSize.x + separation.x)), startPosition.y + offset.y + (y * (tileSize.y + separation.y)) };
+			std::uint8_t* destinationData{ destination + (x * m_numberOfValuesPerPixel) };
+			const Pixel sourcePixel{ sourceImage.priv_decodePixel(source + (x * sourceImage.m_numberOfValuesPerPixel)) };
+			const Pixel destinationPixel{ priv_decodePixel(destinationData) };
+			std::array<std::uint8_t, 4u> result{ destinationPixel.r, destinationPixel.g, destinationPixel.b, destinationPixel.a };
+			const std::array<std::uint8_t, 4u> sourceValues{ sourcePixel.r, sourcePixel.g, sourcePixel.b, sourcePixel.a };
+			priv_blendPixel(result.data(), sourceValues.data(), blendMode, isPremultiplied);
+			priv_encodePixel(destinationData, { result[0u], result[1u], result[2u], result[3u] });
 		}
 	}
-	for (std::size_t yCounter{ 0u }; yCounter < gridSizeRequired.y; ++yCounter)
+}
+
+inline void Image::priv_processAlpha(Rect rect, const bool isPremultiplying)
+{
+	priv_makeRectFullImageSizeIfHasNoSize(rect);
+	if ((rect.position.x >= m_size.x) || (rect.position.y >= m_size.y))
+		return;
+	rect.size.x = std::min(rect.size.x, m_size.x - rect.position.x);
+	rect.size.y = std::min(rect.size.y, m_size.y - rect.position.y);
+
+	auto process = [isPremultiplying](std::uint8_t& colour, const std::uint8_t alpha)
+	{
+		if (isPremultiplying)
+			colour = priv_multiplyChannels(colour, alpha);
+		else if (alpha == 0u)
+			colour = 0u;
+		else
+			colour = static_cast<std::uint8_t>(std::min(((colour * 255u) + (alpha / 2u)) / alpha, 255u));
+	};
+
+	switch (m_pixelFormat)
 	{
-		const std::size_t y{ startPosition.y + offset.y + gridSizeRequired.y - yCounter - 1u };
-		for (std::size_t xCounter{ 0u }; xCounter < gridSizeRequired.x; ++xCounter)
+	case PixelFormat::A8:
+	case PixelFormat::L8:
+		return;
+	case PixelFormat::Indexed8:
 		{
-			const std::size_t x{ startPosition.x + offset.x + gridSizeRequired.x - xCounter - 1u };
+			// only the palette has colour. entries are not shared with other images
+			for (Pixel& colour : m_palette)
+			{
+				process(colour.r, colour.a);
+				process(colour.g, colour.a);
+				process(colour.b, colour.a);
+			}
+		}
+		return;
+	default:
+		break;
+	}
 
-			bool isClearPixel{ true };
+	takeOwnership();
+	const std::size_t alphaOffset{ m_numberOfValuesPerPixel - 1u }; // 3 for RGBA and BGRA, 1 for LA8
+	Parallel::forEach(rect.size.y, [&](const std::size_t y)
+	{
+		std::uint8_t* data{ priv_getPixelData({ rect.position.x, rect.position.y + y }) };
+		for (std::size_t x{ 0u }; x < rect.size.x; ++x)
+		{
+			std::uint8_t* pixel{ data + (x * m_numberOfValuesPerPixel) };
+			for (std::size_t c{ 0u }; c < alphaOffset; ++c)
+				process(pixel[c], pixel[alphaOffset]);
+		}
+	});
+}
 
-			for (const auto& rects : tileRects)
+inline void Image::priv_bleedAlpha(Rect rect)
+{
+	if ((m_pixelFormat == PixelFormat::A8) || (m_pixelFormat == PixelFormat::L8) || (m_pixelFormat == PixelFormat::Indexed8))
+		return;
+	priv_makeRectFullImageSizeIfHasNoSize(rect);
+	if ((rect.position.x >= m_size.x) || (rect.position.y >= m_size.y))
+		return;
+	rect.size.x = std::min(rect.size.x, m_size.x - rect.position.x);
+	rect.size.y = std::min(rect.size.y, m_size.y - rect.position.y);
+
+	// multi-source breadth-first search from every pixel with alpha: each transparent pixel takes the colour of the pixel that reaches it first (nearest by chessboard distance)
+	const std::size_t numberOfPixels{ rect.size.x * rect.size.y };
+	std::vector<Pixel> pixels(numberOfPixels);
+	std::vector<bool> isReached(numberOfPixels, false);
+	std::vector<std::size_t> queue{};
+	queue.reserve(numberOfPixels);
+	for (std::size_t y{ 0u }; y < rect.size.y; ++y)
+	{
+		const std::uint8_t* data{ priv_getPixelData({ rect.position.x, rect.position.y + y }) };
+		for (std::size_t x{ 0u }; x < rect.size.x; ++x)
+		{
+			const std::size_t index{ (y * rect.size.x) + x };
+			pixels[index] = priv_decodePixel(data + (x * m_numberOfValuesPerPixel));
+			if (pixels[index].a > 0u)
 			{
-				if (rects.expanded.contains({ x, y }))
-				{
-					isClearPixel = false;
-
-					Xy local{ x - rects.expanded.position.x, y - rects.expanded.position.y };
-					Xy uv{};
-					if (local.x < expansion)
-						uv.x = 0u;
-					else if (local.x >= (tileSize.x + expansion))
-						uv.x = tileSize.x - 1u;
-					else
-						uv.x = local.x - expansion;
-					if (local.y < expansion)
-						uv.y = 0u;
-					else if (local.y >= (tileSize.y + expansion))
-						uv.y = tileSize.y - 1u;
-					else
-						uv.y = local.y - expansion;
-
-					uv.x += rects.source.position.x;
-					uv.y += rects.source.position.y;
-
-					setPixel({ x, y }, getPixel(uv));
-					break;
-				}
+				isReached[index] = true;
+				queue.push_back(index);
 			}
-			if (isClearPixel)
-				setPixel({ x, y }, emptyPixel);
 		}
 	}
-	if (emptyOrig)
+	if (queue.empty() || (queue.size() == numberOfPixels))
+		return;
+
+	for (std::size_t front{ 0u }; front < queue.size(); ++front)
 	{
-		for (std::size_t y{ 0u }; y < origGridSize.y; ++y)
+		const std::size_t index{ queue[front] };
+		const std::size_t x{ index % rect.size.x };
+		const std::size_t y{ index / rect.size.x };
+		const std::size_t startX{ (x > 0u) ? (x - 1u) : 0u };
+		const std::size_t startY{ (y > 0u) ? (y - 1u) : 0u };
+		const std::size_t endX{ std::min(x + 2u, rect.size.x) };
+		const std::size_t endY{ std::min(y + 2u, rect.size.y) };
+		for (std::size_t neighbourY{ startY }; neighbourY < endY; ++neighbourY)
 		{
-			for (std::size_t x{ 0u }; x < origGridSize.x; ++x)
+			for (std::size_t neighbourX{ startX }; neighbourX < endX; ++neighbourX)
 			{
-				if ((x >= offset.x) && (y >= offset.y))
+				const std::size_t neighbourIndex{ (neighbourY * rect.size.x) + neighbourX };
+				if (isReached[neighbourIndex])
 					continue;
-				setPixel({ x, y }, emptyPixel);
+				isReached[neighbourIndex] = true;
+				Pixel& neighbour{ pixels[neighbourIndex] };
+				neighbour = { pixels[index].r, pixels[index].g, pixels[index].b, neighbour.a };
+				queue.push_back(neighbourIndex);
+
+				std::uint8_t* data{ priv_getPixelData({ rect.position.x + neighbourX, rect.position.y + neighbourY }) };
+				priv_encodePixel(data, neighbour);
 			}
 		}
 	}
-	Atlas atlas{};
-	const std::size_t numberOfTileRects{ tileRects.size() };
-	atlas.resize(numberOfTileRects);
-	Atlas::Tile tile{};
-	tile.category = category;
-	for (std::size_t i{ 0u }; i < numberOfTileRects; ++i)
+}
+
+inline void Image::priv_generateDistanceField(const Rect rect, const std::size_t spread, const std::uint8_t threshold, const bool isMaskFromAlpha)
+{
+	if ((rect.position.x >= m_size.x) || (rect.position.y >= m_size.y))
+		return;
+
+	// the field covers the rect and its spread, clipped to the image
+	const Xy start{ (rect.position.x > spread) ? (rect.position.x - spread) : 0u, (rect.position.y > spread) ? (rect.position.y - spread) : 0u };
+	const Xy end{ std::min(rect.position.x + rect.size.x + spread, m_size.x), std::min(rect.position.y + rect.size.y + spread, m_size.y) };
+	const Xy size{ end.x - start.x, end.y - start.y };
+	const std::size_t numberOfPixels{ size.x * size.y };
+
+	std::vector<bool> isInside(numberOfPixels);
+	for (std::size_t y{ 0u }; y < size.y; ++y)
 	{
-		tile.rect = tileRects[i].expanded;
-		tile.id = initId + i;
-		atlas.set(i, tile);
+		const std::uint8_t* data{ priv_getPixelData({ start.x, start.y + y }) };
+		for (std::size_t x{ 0u }; x < size.x; ++x)
+		{
+			const Pixel pixel{ priv_decodePixel(data + (x * m_numberOfValuesPerPixel)) };
+			const std::uint8_t value{ isMaskFromAlpha ? pixel.a : static_cast<std::uint8_t>(((pixel.r * 77u) + (pixel.g * 150u) + (pixel.b * 29u) + 128u) >> 8u) };
+			isInside[(y * size.x) + x] = (value >= threshold);
+		}
+	}
+
+	// exact squared Euclidean distances to the nearest inside pixel and to the nearest outside pixel, each separably (columns then rows)
+	constexpr float infinity{ 1e20f };
+	const std::size_t longestSide{ std::max(size.x, size.y) };
+	std::vector<float> distances(longestSide);
+	std::vector<std::size_t> parabolas(longestSide);
+	std::vector<float> boundaries(longestSide + 1u);
+	auto transform = [&](std::vector<float>& field)
+	{
+		for (std::size_t x{ 0u }; x < size.x; ++x)
+			priv_transformDistances(field.data() + x, size.y, size.x, distances, parabolas, boundaries);
+		for (std::size_t y{ 0u }; y < size.y; ++y)
+			priv_transformDistances(field.data() + (y * size.x), size.x, 1u, distances, parabolas, boundaries);
+	};
+	std::vector<float> toInside(numberOfPixels);
+	std::vector<float> toOutside(numberOfPixels);
+	for (std::size_t i{ 0u }; i < numberOfPixels; ++i)
+	{
+		toInside[i] = isInside[i] ? 0.f : infinity;
+		toOutside[i] = isInside[i] ? infinity : 0.f;
+	}
+	transform(toInside);
+	transform(toOutside);
+
+	// the edge is half way between pixel centres
+	const float scale{ 127.f / static_cast<float>(std::max(spread, std::size_t{ 1u })) };
+	for (std::size_t y{ 0u }; y < size.y; ++y)
+	{
+		std::uint8_t* data{ priv_getPixelData({ start.x, start.y + y }) };
+		for (std::size_t x{ 0u }; x < size.x; ++x)
+		{
+			const std::size_t index{ (y * size.x) + x };
+			const float distance{ isInside[index] ? (std::sqrt(toOutside[index]) - 0.5f) : (0.5f - std::sqrt(toInside[index])) };
+			const std::uint8_t value{ static_cast<std::uint8_t>(std::clamp(128.f + (distance * scale), 0.f, 255.f) + 0.5f) };
+			priv_encodePixel(data + (x * m_numberOfValuesPerPixel), { value, value, value, value });
+		}
 	}
-	return atlas;
 }
 
-inline const std::uint8_t* Image::getData() const
+inline void Image::priv_transformDistances(float* values, const std::size_t numberOfValues, const std::size_t step, std::vector<float>& distances, std::vector<std::size_t>& parabolas, std::vector<float>& boundaries)
 {
-	if (m_data.empty())
-		throw Exception("Cannot get data for an empty image.");
+	// one-dimensional squared distance transform (Felzenszwalb and Huttenlocher): the lower envelope of parabolas rooted at each sample. values are read and written every step floats
+	constexpr float infinity{ 1e20f };
+	auto value = [&](const std::size_t i) -> float& { return values[i * step]; };
+	std::size_t k{ 0u };
+	parabolas[0u] = 0u;
+	boundaries[0u] = -infinity;
+	boundaries[1u] = infinity;
+	for (std::size_t q{ 1u }; q < numberOfValues; ++q)
+	{
+		const float fq{ value(q) + static_cast<float>(q * q) };
+		auto getIntersection = [&](const std::size_t p) { return (fq - (value(p) + static_cast<float>(p * p))) / (2.f * static_cast<float>(q - p)); };
+		float intersection{ getIntersection(parabolas[k]) };
+		while (intersection <= boundaries[k]) // never passes the first boundary (-infinity)
+		{
+			--k;
+			intersection = getIntersection(parabolas[k]);
+		}
+		++k;
+		parabolas[k] = q;
+		boundaries[k] = intersection;
+		boundaries[k + 1u] = infinity;
+	}
 
-	return m_data.data();
+	k = 0u;
+	for (std::size_t q{ 0u }; q < numberOfValues; ++q)
+	{
+		while (boundaries[k + 1u] < static_cast<float>(q))
+			++k;
+		const std::size_t p{ parabolas[k] };
+		const float difference{ static_cast<float>(q) - static_cast<float>(p) };
+		distances[q] = (difference * difference) + value(p);
+	}
+	for (std::size_t q{ 0u }; q < numberOfValues; ++q)
+		value(q) = distances[q];
 }
 
-inline bool Image::priv_isValidIndex(const std::size_t index) const
+inline void Image::priv_blendPixel(std::uint8_t* destination, const std::uint8_t* source, const BlendMode blendMode, const bool isPremultiplied)
 {
-	return ((index * m_numberOfValuesPerPixel) < m_data.size());
+	// blending is done premultiplied in 8-bit fixed point
+	std::array<std::uint32_t, 4u> s{ source[0u], source[1u], source[2u], source[3u] };
+	std::array<std::uint32_t, 4u> d{ destination[0u], destination[1u], destination[2u], destination[3u] };
+	if (!isPremultiplied)
+	{
+		for (std::size_t c{ 0u }; c < 3u; ++c)
+		{
+			s[c] = priv_multiplyChannels(s[c], s[3u]);
+			d[c] = priv_multiplyChannels(d[c], d[3u]);
+		}
+	}
+
+	const std::uint32_t inverseSourceAlpha{ 255u - s[3u] };
+	const std::uint32_t inverseDestinationAlpha{ 255u - d[3u] };
+	std::array<std::uint32_t, 4u> result{};
+	switch (blendMode)
+	{
+	case BlendMode::SourceOver:
+		for (std::size_t c{ 0u }; c < 4u; ++c)
+			result[c] = s[c] + priv_multiplyChannels(d[c], inverseSourceAlpha);
+		break;
+	case BlendMode::Additive:
+		for (std::size_t c{ 0u }; c < 4u; ++c)
+			result[c] = s[c] + d[c];
+		break;
+	case BlendMode::Multiply:
+		for (std::size_t c{ 0u }; c < 3u; ++c)
+			result[c] = priv_multiplyChannels(s[c], d[c]) + priv_multiplyChannels(s[c], inverseDestinationAlpha) + priv_multiplyChannels(d[c], inverseSourceAlpha);
+		result[3u] = s[3u] + priv_multiplyChannels(d[3u], inverseSourceAlpha);
+		break;
+	}
+
+	const std::uint32_t alpha{ std::min(result[3u], 255u) };
+	destination[3u] = static_cast<std::uint8_t>(alpha);
+	for (std::size_t c{ 0u }; c < 3u; ++c)
+	{
+		if (isPremultiplied)
+			destination[c] = static_cast<std::uint8_t>(std::min(result[c], 255u));
+		else
+		{
+			// straight colour cannot be brighter than its alpha allows
+			const std::uint32_t colour{ std::min(result[c], alpha) };
+			destination[c] = (alpha == 0u) ? 0u : static_cast<std::uint8_t>(((colour * 255u) + (alpha / 2u)) / alpha);
+		}
+	}
 }
 
-inline std::size_t Image::priv_getIndexFromLocation(const Xy location) const
+inline std::uint8_t Image::priv_multiplyChannels(const std::uint32_t a, const std::uint32_t b)
 {
-	const std::size_t outOfBoundsIndex{ m_size.x * m_size.y };
-	if ((location.x >= m_size.x) || (location.y >= m_size.y))
-		return outOfBoundsIndex;
-	return (location.y * m_size.x) + location.x;
+	const std::uint32_t product{ (a * b) + 128u };
+	return static_cast<std::uint8_t>((product + (product >> 8u)) >> 8u);
 }
 
-inline void Image::priv_setPixel(const std::size_t index, const Pixel& pixel)
+inline void Image::priv_extrude(const Rect rect, const std::size_t expansion)
 {
-	assert(priv_isValidIndex(index));
+	// the expanded rect must fit within the image. left and right padding are splats of each row's edge pixels and then top and bottom padding are whole copies of the first and last (padded) rows
+	if ((expansion == 0u) || priv_rectHasNoSize(rect))
+		return;
 
-	const std::size_t dataIndexStart{ index * m_numberOfValuesPerPixel };
-	const bool isRgba{ m_pixelFormat == PixelFormat::RGBA };
-	m_data[dataIndexStart + 0u] = isRgba ? pixel.r : pixel.b;
-	m_data[dataIndexStart + 1u] = pixel.g;
-	m_data[dataIndexStart + 2u] = isRgba ? pixel.b : pixel.r;
-	m_data[dataIndexStart + 3u] = pixel.a;
+	const Xy bottomRight{ rect.getBottomRight() };
+	for (std::size_t y{ rect.position.y }; y <= bottomRight.y; ++y)
+	{
+		priv_splatPixel(priv_getPixelData({ rect.position.x - expansion, y }), priv_getPixelData({ rect.position.x, y }), expansion);
+		priv_splatPixel(priv_getPixelData({ bottomRight.x + 1u, y }), priv_getPixelData({ bottomRight.x, y }), expansion);
+	}
+
+	const std::size_t rowSize{ (rect.size.x + expansion + expansion) * m_numberOfValuesPerPixel };
+	const std::size_t left{ rect.position.x - expansion };
+	const std::uint8_t* topRow{ priv_getPixelData({ left, rect.position.y }) };
+	const std::uint8_t* bottomRow{ priv_getPixelData({ left, bottomRight.y }) };
+	for (std::size_t e{ 1u }; e <= expansion; ++e)
+	{
+		std::memcpy(priv_getPixelData({ left, rect.position.y - e }), topRow, rowSize);
+		std::memcpy(priv_getPixelData({ left, bottomRight.y + e }), bottomRow, rowSize);
+	}
 }
 
-inline Pixel Image::priv_getPixel(const std::size_t index) const
+inline bool Image::priv_separateGridTiles(
+	const Xy startPosition,
+	const Xy offset,
+	const Xy gridSize,
+	const Xy tileSize,
+	Xy& separation,
+	std::size_t& expansion,
+	const Xy origSeparation,
+	const bool emptyOrig,
+	const Pixel emptyPixel)
 {
-	assert(priv_isValidIndex(index));
+	if ((expansion * 2u) > separation.x)
+		expansion = separation.x / 2u;
+	if ((expansion * 2u) > separation.y)
+		expansion = separation.y / 2u;
+	if (separation.x < origSeparation.x)
+		separation.x = origSeparation.x;
+	if (separation.y < origSeparation.y)
+		separation.y = origSeparation.y;
 
-	Pixel pixel{};
-	const std::size_t dataIndexStart{ index * m_numberOfValuesPerPixel };
-	const bool isRgba{ m_pixelFormat == PixelFormat::RGBA };
+	const Xy origGridSize{ gridSize.x * (tileSize.x + origSeparation.x) - origSeparation.x, gridSize.y * (tileSize.y + origSeparation.y) - origSeparation.y };
+	const Xy gridSizeRequired{ gridSize.x * (tileSize.x + separation.x) - separation.x + (expansion * 2u), gridSize.y * (tileSize.y + separation.y) - separation.y + (expansion * 2u) };
 
-	pixel.r = m_data[dataIndexStart + (isRgba ? 0u : 2u)];
-	pixel.g = m_data[dataIndexStart + 1u];
-	pixel.b = m_data[dataIndexStart + (isRgba ? 2u : 0u)];
-	pixel.a = m_data[dataIndexStart + 3u];
+	if ((startPosition.x + offset.x + gridSizeRequired.x) > m_size.x)
+		return false;
+	if ((startPosition.y + offset.y + gridSizeRequired.y) > m_size.y)
+		return false;
+
+	const Rect origRect{ startPosition, origGridSize };
+	const Rect requiredRect{ startPosition + offset, gridSizeRequired };
+
+	// if the tiles would be written over the original grid, read them from a copy of it instead so that the tiles can be processed in any order
+	Image copyImage{};
+	const Image* sourceImage{ this };
+	Xy sourcePosition{ startPosition };
+	const bool isOverlapping{
+		(origRect.position.x < (requiredRect.position.x + requiredRect.size.x)) && (requiredRect.position.x < (origRect.position.x + origRect.size.x)) &&
+		(origRect.position.y < (requiredRect.position.y + requiredRect.size.y)) && (requiredRect.position.y < (origRect.position.y + origRect.size.y)) };
+	if (isOverlapping)
+	{
+		copyImage.setPalette(m_palette);
+		copyImage.setPixelFormat(m_pixelFormat, false);
+		copyImage.setScratchPool(m_scratchPool);
+		copyImage.setSize(origGridSize, false);
+		copyImage.copy({ 0u, 0u }, *this, origRect);
+		sourceImage = &copyImage;
+		sourcePosition = { 0u, 0u };
+	}
 
-	return pixel;
+	clear(requiredRect, emptyPixel);
+	takeOwnership();
+
+	// each tile's source and (expanded) destination are found directly from its grid coordinate
+	Parallel::forEach(gridSize.x * gridSize.y, [&](const std::size_t tileIndex)
+	{
+		const Xy gridPosition{ tileIndex % gridSize.x, tileIndex / gridSize.x };
+		const Rect sourceRect{ sourcePosition + gridPosition * (tileSize + origSeparation), tileSize };
+		const Xy position{ requiredRect.position + gridPosition * (tileSize + separation) + Xy{ expansion, expansion } };
+		copy(position, *sourceImage, sourceRect, expansion);
+	});
+
+	if (emptyOrig)
+	{
+		for (std::size_t y{ 0u }; y < origGridSize.y; ++y)
+		{
+			for (std::size_t x{ 0u }; x < origGridSize.x; ++x)
+			{
+				if ((x >= offset.x) && (y >= offset.y))
+					continue;
+				setPixel({ x, y }, emptyPixel);
+			}
+		}
+	}
+	return true;
 }
 
 inline bool Image::priv_rectHasNoSize(const Rect rect) const
@@ -1037,6 +2177,11 @@ inline bool Image::priv_rectHasNoSize(const Rect rect) const
 	return (rect.size.x == 0u) || (rect.size.y == 0u);
 }
 
+inline bool Image::priv_isRectWithinImage(const Rect rect) const
+{
+	return (rect.position.x < m_size.x) && (rect.position.y < m_size.y) && Rect{ { 0u, 0u }, m_size }.contains(rect);
+}
+
 inline void Image::priv_makeRectFullImageSizeIfHasNoSize(Rect& rect) const
 {
 	if (priv_rectHasNoSize(rect))
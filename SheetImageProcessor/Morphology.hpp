@@ -0,0 +1,73 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Sheet Image Processor (https://github.com/Hapaxia/SheetImageProcessor
+// --
+//
+// Morphology
+//
+// Copyright(c) 2025-2026 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions :
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software.If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Common.hpp"
+#include "Image.hpp"
+#include "Atlas.hpp"
+
+namespace sheetimageprocessor
+{
+
+// morphology on alpha (the luminance of L8 images) within a rect or within each tile of an atlas, using a square of (2 x radius + 1) pixels.
+// running minimums and maximums (van Herk/Gil-Werman) keep the cost per pixel independent of the radius
+class Morphology
+{
+public:
+	enum class Operation
+	{
+		Dilate, // grows the shape
+		Erode, // shrinks the shape
+		Open, // erodes and then dilates: removes thin parts
+		Close, // dilates and then erodes: fills small gaps
+	};
+
+	static void apply(Image& image, Operation operation, std::size_t radius, Rect rect = Rect{});
+	static void apply(Image& image, const Atlas& atlas, Operation operation, std::size_t radius);
+	static void outline(Image& image, std::size_t width, Pixel colour, Rect rect = Rect{}); // draws the shape over its own dilation in colour
+	static void outline(Image& image, const Atlas& atlas, std::size_t width, Pixel colour);
+
+private:
+	static void priv_process(Image& image, const std::vector<Rect>& rects, const std::function<void(Image&, Rect, bool)>& processRect);
+	static void priv_applyRect(Image& image, Rect rect, Operation operation, std::size_t radius, bool isParallel);
+	static void priv_outlineRect(Image& image, Rect rect, std::size_t width, Pixel colour, bool isParallel);
+	static bool priv_clipRect(const Image& image, Rect& rect);
+	static Image priv_copyRect(Image& image, Rect rect); // as RGBA
+	static std::vector<std::uint8_t> priv_getMask(const Image& image, const Image& tile);
+	static void priv_setMask(const Image& image, Image& tile, const std::vector<std::uint8_t>& mask);
+	static void priv_filterMask(std::vector<std::uint8_t>& mask, Xy size, bool isMaximum, std::size_t radius, bool isParallel);
+	static void priv_filterLine(std::uint8_t* line, std::size_t length, std::size_t step, bool isMaximum, std::size_t radius, std::vector<std::uint8_t>& padded, std::vector<std::uint8_t>& forward, std::vector<std::uint8_t>& backward);
+};
+
+} // namespace sheetimageprocessor
+#include "Morphology.inl"
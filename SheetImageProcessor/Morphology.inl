@@ -0,0 +1,250 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Sheet Image Processor (https://github.com/Hapaxia/SheetImageProcessor
+// --
+//
+// Morphology
+//
+// Copyright(c) 2025-2026 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions :
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software.If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "Morphology.hpp"
+
+#include <algorithm>
+
+namespace sheetimageprocessor
+{
+
+inline void Morphology::apply(Image& image, const Operation operation, const std::size_t radius, const Rect rect)
+{
+	priv_process(image, { rect }, [&](Image& target, const Rect targetRect, const bool isParallel) { priv_applyRect(target, targetRect, operation, radius, isParallel); });
+}
+
+inline void Morphology::apply(Image& image, const Atlas& atlas, const Operation operation, const std::size_t radius)
+{
+	std::vector<Rect> rects{};
+	for (const Atlas::Tile& tile : atlas.constAccess())
+	{
+		if ((tile.rect.size.x > 0u) && (tile.rect.size.y > 0u))
+			rects.push_back(tile.rect);
+	}
+	priv_process(image, rects, [&](Image& target, const Rect targetRect, const bool isParallel) { priv_applyRect(target, targetRect, operation, radius, isParallel); });
+}
+
+inline void Morphology::outline(Image& image, const std::size_t width, const Pixel colour, const Rect rect)
+{
+	priv_process(image, { rect }, [&](Image& target, const Rect targetRect, const bool isParallel) { priv_outlineRect(target, targetRect, width, colour, isParallel); });
+}
+
+inline void Morphology::outline(Image& image, const Atlas& atlas, const std::size_t width, const Pixel colour)
+{
+	std::vector<Rect> rects{};
+	for (const Atlas::Tile& tile : atlas.constAccess())
+	{
+		if ((tile.rect.size.x > 0u) && (tile.rect.size.y > 0u))
+			rects.push_back(tile.rect);
+	}
+	priv_process(image, rects, [&](Image& target, const Rect targetRect, const bool isParallel) { priv_outlineRect(target, targetRect, width, colour, isParallel); });
+}
+
+inline void Morphology::priv_process(Image& image, const std::vector<Rect>& rects, const std::function<void(Image&, Rect, bool)>& processRect)
+{
+	const Xy imageSize{ image.getSize() };
+	if ((imageSize.x == 0u) || (imageSize.y == 0u))
+		return;
+	image.takeOwnership();
+
+	// a single rect is processed with its rows (and columns) in parallel; otherwise the rects are
+	if (rects.size() == 1u)
+	{
+		processRect(image, rects[0u], true);
+		return;
+	}
+	Parallel::forEach(rects.size(), [&](const std::size_t i)
+	{
+		processRect(image, rects[i], false);
+	});
+}
+
+inline void Morphology::priv_applyRect(Image& image, Rect rect, const Operation operation, const std::size_t radius, const bool isParallel)
+{
+	if (!priv_clipRect(image, rect) || (radius == 0u))
+		return;
+
+	Image tile{ priv_copyRect(image, rect) };
+	std::vector<std::uint8_t> mask{ priv_getMask(image, tile) };
+	switch (operation)
+	{
+	case Operation::Dilate:
+		priv_filterMask(mask, rect.size, true, radius, isParallel);
+		break;
+	case Operation::Erode:
+		priv_filterMask(mask, rect.size, false, radius, isParallel);
+		break;
+	case Operation::Open:
+		priv_filterMask(mask, rect.size, false, radius, isParallel);
+		priv_filterMask(mask, rect.size, true, radius, isParallel);
+		break;
+	case Operation::Close:
+		priv_filterMask(mask, rect.size, true, radius, isParallel);
+		priv_filterMask(mask, rect.size, false, radius, isParallel);
+		break;
+	}
+	priv_setMask(image, tile, mask);
+	image.copy(rect.position, tile, { { 0u, 0u }, rect.size });
+}
+
+inline void Morphology::priv_outlineRect(Image& image, Rect rect, const std::size_t width, const Pixel colour, const bool isParallel)
+{
+	if (!priv_clipRect(image, rect))
+		return;
+
+	Image tile{ priv_copyRect(image, rect) };
+	std::vector<std::uint8_t> mask{ priv_getMask(image, tile) };
+	priv_filterMask(mask, rect.size, true, width, isParallel);
+
+	// the outline takes its coverage from the dilated mask and the original is drawn over it
+	Image outlineTile{};
+	outlineTile.setScratchPool(image.getScratchPool());
+	outlineTile.setSize(rect.size, false);
+	for (std::size_t y{ 0u }; y < rect.size.y; ++y)
+	{
+		std::uint8_t* row{ outlineTile.accessRowData(y) };
+		for (std::size_t x{ 0u }; x < rect.size.x; ++x)
+		{
+			const std::uint32_t coverage{ (colour.a * static_cast<std::uint32_t>(mask[(y * rect.size.x) + x])) + 127u };
+			row[(x * 4u) + 0u] = colour.r;
+			row[(x * 4u) + 1u] = colour.g;
+			row[(x * 4u) + 2u] = colour.b;
+			row[(x * 4u) + 3u] = static_cast<std::uint8_t>(coverage / 255u);
+		}
+	}
+	outlineTile.blend({ 0u, 0u }, tile, { { 0u, 0u }, rect.size });
+	image.copy(rect.position, outlineTile, { { 0u, 0u }, rect.size });
+}
+
+inline bool Morphology::priv_clipRect(const Image& image, Rect& rect)
+{
+	const Xy imageSize{ image.getSize() };
+	if ((rect.size.x == 0u) || (rect.size.y == 0u))
+		rect = { { 0u, 0u }, imageSize };
+	if ((rect.position.x >= imageSize.x) || (rect.position.y >= imageSize.y))
+		return false;
+	rect.size.x = std::min(rect.size.x, imageSize.x - rect.position.x);
+	rect.size.y = std::min(rect.size.y, imageSize.y - rect.position.y);
+	return ((rect.size.x > 0u) && (rect.size.y > 0u));
+}
+
+inline Image Morphology::priv_copyRect(Image& image, const Rect rect)
+{
+	// tile rows are the same as its locations (it is top-down)
+	Image tile{};
+	tile.setScratchPool(image.getScratchPool());
+	tile.setSize(rect.size, false);
+	tile.copy({ 0u, 0u }, image, rect);
+	return tile;
+}
+
+inline std::vector<std::uint8_t> Morphology::priv_getMask(const Image& image, const Image& tile)
+{
+	// L8 has no alpha so its luminance is used
+	const std::size_t channel{ (image.getPixelFormat() == Image::PixelFormat::L8) ? 0u : 3u };
+	const Xy size{ tile.getSize() };
+	std::vector<std::uint8_t> mask(size.x * size.y);
+	for (std::size_t y{ 0u }; y < size.y; ++y)
+	{
+		const std::uint8_t* row{ tile.getRowData(y) };
+		for (std::size_t x{ 0u }; x < size.x; ++x)
+			mask[(y * size.x) + x] = row[(x * 4u) + channel];
+	}
+	return mask;
+}
+
+inline void Morphology::priv_setMask(const Image& image, Image& tile, const std::vector<std::uint8_t>& mask)
+{
+	const bool isLuminance{ image.getPixelFormat() == Image::PixelFormat::L8 };
+	const Xy size{ tile.getSize() };
+	for (std::size_t y{ 0u }; y < size.y; ++y)
+	{
+		std::uint8_t* row{ tile.accessRowData(y) };
+		for (std::size_t x{ 0u }; x < size.x; ++x)
+		{
+			const std::uint8_t value{ mask[(y * size.x) + x] };
+			if (isLuminance)
+				row[(x * 4u) + 0u] = row[(x * 4u) + 1u] = row[(x * 4u) + 2u] = value;
+			else
+				row[(x * 4u) + 3u] = value;
+		}
+	}
+}
+
+inline void Morphology::priv_filterMask(std::vector<std::uint8_t>& mask, const Xy size, const bool isMaximum, const std::size_t radius, const bool isParallel)
+{
+	// rows and then columns. each job has its own working lines (allocated once) and takes every (number of jobs)th line
+	const std::size_t longestSide{ std::max(size.x, size.y) + (radius * 2u) };
+	auto filterLines = [&](const std::size_t numberOfLines, const std::size_t lineStep, const std::size_t length, const std::size_t step)
+	{
+		const std::size_t numberOfJobs{ isParallel ? std::max(std::min(Parallel::getMaxNumberOfThreads(), numberOfLines), std::size_t{ 1u }) : 1u };
+		auto filterJob = [&, lineStep, length, step](const std::size_t job)
+		{
+			std::vector<std::uint8_t> padded(longestSide);
+			std::vector<std::uint8_t> forward(longestSide);
+			std::vector<std::uint8_t> backward(longestSide);
+			for (std::size_t line{ job }; line < numberOfLines; line += numberOfJobs)
+				priv_filterLine(mask.data() + (line * lineStep), length, step, isMaximum, radius, padded, forward, backward);
+		};
+		if (numberOfJobs > 1u)
+			Parallel::forEach(numberOfJobs, filterJob);
+		else
+			filterJob(0u);
+	};
+	filterLines(size.y, size.x, size.x, 1u);
+	filterLines(size.x, 1u, size.y, size.x);
+}
+
+inline void Morphology::priv_filterLine(std::uint8_t* line, const std::size_t length, const std::size_t step, const bool isMaximum, const std::size_t radius, std::vector<std::uint8_t>& padded, std::vector<std::uint8_t>& forward, std::vector<std::uint8_t>& backward)
+{
+	// the line is padded by radius on each side with the operation's identity (so the ends are not affected by what is outside the rect). each window of (2 x radius + 1) spans at most two blocks of that size: the end of one (a running result backwards from each block's end) and the start of the next (a running result forwards from each block's start)
+	const std::uint8_t identity{ isMaximum ? std::uint8_t{ 0u } : std::uint8_t{ 255u } };
+	auto combine = [isMaximum](const std::uint8_t a, const std::uint8_t b) { return isMaximum ? std::max(a, b) : std::min(a, b); };
+	const std::size_t windowSize{ (radius * 2u) + 1u };
+	const std::size_t paddedLength{ length + (radius * 2u) };
+	std::fill(padded.begin(), padded.begin() + paddedLength, identity);
+	for (std::size_t i{ 0u }; i < length; ++i)
+		padded[radius + i] = line[i * step];
+
+	for (std::size_t i{ 0u }; i < paddedLength; ++i)
+		forward[i] = ((i % windowSize) == 0u) ? padded[i] : combine(forward[i - 1u], padded[i]);
+	for (std::size_t i{ paddedLength }; i > 0u; --i)
+	{
+		const std::size_t index{ i - 1u };
+		backward[index] = ((index == (paddedLength - 1u)) || (((index + 1u) % windowSize) == 0u)) ? padded[index] : combine(backward[index + 1u], padded[index]);
+	}
+	for (std::size_t i{ 0u }; i < length; ++i)
+		line[i * step] = combine(backward[i], forward[i + windowSize - 1u]);
+}
+
+} // namespace sheetimageprocessor
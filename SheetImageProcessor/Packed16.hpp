@@ -0,0 +1,72 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Sheet Image Processor (https://github.com/Hapaxia/SheetImageProcessor
+// --
+//
+// Packed16
+//
+// Copyright(c) 2025-2026 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions :
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software.If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Common.hpp"
+#include "Image.hpp"
+#include "Atlas.hpp"
+
+namespace sheetimageprocessor
+{
+
+// converts an image to packed 16-bit pixels (in native byte order, as for an array of std::uint16_t) in a caller-supplied buffer.
+// rows are written in the image's stored order. with dithering, each atlas tile is dithered on its own (so that noise does not cross tile edges); pixels outside tiles are not dithered.
+// only the colour channels are dithered: alpha is rounded
+class Packed16
+{
+public:
+	enum class Format
+	{
+		RGB565,
+		RGBA4444,
+		RGBA5551,
+	};
+	enum class Dither
+	{
+		None,
+		Ordered, // 4x4 Bayer matrix, anchored at each tile's top-left
+		ErrorDiffusion, // Floyd-Steinberg
+	};
+
+	static std::size_t getRequiredSize(Xy size, std::size_t rowStride = 0u); // in bytes. rowStride is in bytes (0 packs rows tightly)
+	static void convert(const Image& image, std::uint8_t* destination, std::size_t destinationSize, Format format, Dither dither = Dither::None, const Atlas& atlas = Atlas{}, std::size_t rowStride = 0u); // an empty atlas dithers the whole image as one tile. tiles must not overlap
+
+private:
+	static constexpr std::size_t m_numberOfRowsPerJob{ 32u };
+
+	static std::array<std::size_t, 4u> priv_getNumberOfBits(Format format); // r, g, b, a
+	static void priv_convertRect(const Image& image, Rect rect, std::uint8_t* destination, std::size_t rowStride, Format format, Dither dither);
+};
+
+} // namespace sheetimageprocessor
+#include "Packed16.inl"
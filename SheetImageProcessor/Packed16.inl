@@ -0,0 +1,200 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Sheet Image Processor (https://github.com/Hapaxia/SheetImageProcessor
+// --
+//
+// Packed16
+//
+// Copyright(c) 2025-2026 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions :
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software.If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "Packed16.hpp"
+
+#include <cstring>
+
+namespace sheetimageprocessor
+{
+
+inline std::size_t Packed16::getRequiredSize(const Xy size, const std::size_t rowStride)
+{
+	if (size.y == 0u)
+		return 0u;
+	const std::size_t rowSize{ size.x * 2u };
+	return ((size.y - 1u) * std::max(rowStride, rowSize)) + rowSize;
+}
+
+inline void Packed16::convert(const Image& image, std::uint8_t* destination, const std::size_t destinationSize, const Format format, const Dither dither, const Atlas& atlas, std::size_t rowStride)
+{
+	const Xy size{ image.getSize() };
+	if (rowStride == 0u)
+		rowStride = size.x * 2u;
+	if (rowStride < (size.x * 2u))
+		throw Exception("Cannot convert to packed 16-bit: row stride is smaller than a row.");
+	if (destinationSize < getRequiredSize(size, rowStride))
+		throw Exception("Cannot convert to packed 16-bit: destination is too small.");
+	if ((size.x == 0u) || (size.y == 0u))
+		return;
+
+	// without an atlas, the whole image is one tile
+	if ((dither != Dither::None) && (atlas.getSize() == 0u))
+	{
+		priv_convertRect(image, { { 0u, 0u }, size }, destination, rowStride, format, dither);
+		return;
+	}
+
+	// every pixel is converted without dithering, in bands of rows
+	Parallel::forEach((size.y + m_numberOfRowsPerJob - 1u) / m_numberOfRowsPerJob, [&](const std::size_t jobIndex)
+	{
+		const std::size_t firstRow{ jobIndex * m_numberOfRowsPerJob };
+		priv_convertRect(image, { { 0u, firstRow }, { size.x, std::min(m_numberOfRowsPerJob, size.y - firstRow) } }, destination, rowStride, format, Dither::None);
+	});
+	if (dither == Dither::None)
+		return;
+
+	// and then each tile is converted again, dithered
+	const std::vector<Atlas::Tile>& tiles{ atlas.constAccess() };
+	Parallel::forEach(tiles.size(), [&](const std::size_t tileIndex)
+	{
+		Rect rect{ tiles[tileIndex].rect };
+		if ((rect.position.x >= size.x) || (rect.position.y >= size.y))
+			return;
+		rect.size.x = std::min(rect.size.x, size.x - rect.position.x);
+		rect.size.y = std::min(rect.size.y, size.y - rect.position.y);
+		priv_convertRect(image, rect, destination, rowStride, format, dither);
+	});
+}
+
+inline std::array<std::size_t, 4u> Packed16::priv_getNumberOfBits(const Format format)
+{
+	switch (format)
+	{
+	case Format::RGBA4444:
+		return { 4u, 4u, 4u, 4u };
+	case Format::RGBA5551:
+		return { 5u, 5u, 5u, 1u };
+	case Format::RGB565:
+	default:
+		return { 5u, 6u, 5u, 0u };
+	}
+}
+
+inline void Packed16::priv_convertRect(const Image& image, const Rect rect, std::uint8_t* destination, const std::size_t rowStride, const Format format, const Dither dither)
+{
+	// rect must be within the image and not have any zero size
+	const std::array<std::size_t, 4u> numberOfBits{ priv_getNumberOfBits(format) };
+	std::array<int, 4u> maxValues{};
+	std::array<std::size_t, 4u> shifts{};
+	std::size_t shift{ 16u };
+	for (std::size_t c{ 0u }; c < 4u; ++c)
+	{
+		maxValues[c] = (1 << numberOfBits[c]) - 1;
+		shift -= numberOfBits[c];
+		shifts[c] = shift;
+	}
+
+	// compact images are converted to RGBA a row at a time
+	const bool isCompact{ image.getNumberOfValuesPerPixel() != 4u };
+	const bool isRgba{ isCompact || (image.getPixelFormat() == Image::PixelFormat::RGBA) };
+	const std::array<std::size_t, 4u> offsets{ isRgba ? 0u : 2u, 1u, isRgba ? 2u : 0u, 3u };
+	Image rowImage{};
+	if (isCompact)
+		rowImage.setSize({ rect.size.x, 1u }, false);
+
+	// 4x4 Bayer matrix
+	constexpr std::array<int, 16u> thresholds{ 0, 8, 2, 10, 12, 4, 14, 6, 3, 11, 1, 9, 15, 7, 13, 5 };
+
+	// error diffusion keeps (16 times) the error carried into the current and the next row, for each colour channel, with a pixel of margin at each end
+	std::vector<int> errors{};
+	std::vector<int> nextErrors{};
+	if (dither == Dither::ErrorDiffusion)
+	{
+		errors.assign((rect.size.x + 2u) * 3u, 0);
+		nextErrors.assign((rect.size.x + 2u) * 3u, 0);
+	}
+
+	for (std::size_t y{ 0u }; y < rect.size.y; ++y)
+	{
+		const std::size_t imageY{ rect.position.y + y };
+		const std::uint8_t* source{ nullptr };
+		if (isCompact)
+		{
+			rowImage.copy({ 0u, 0u }, image, { { rect.position.x, imageY }, { rect.size.x, 1u } });
+			source = rowImage.getRowData(0u);
+		}
+		else
+			source = image.getRowData(imageY) + (rect.position.x * 4u);
+		std::uint8_t* row{ destination + (imageY * rowStride) + (rect.position.x * 2u) };
+
+		switch (dither)
+		{
+		case Dither::None:
+			for (std::size_t x{ 0u }; x < rect.size.x; ++x)
+			{
+				std::uint16_t value{ 0u };
+				for (std::size_t c{ 0u }; c < 4u; ++c)
+					value |= static_cast<std::uint16_t>(((source[(x * 4u) + offsets[c]] * maxValues[c]) + 127) / 255) << shifts[c];
+				std::memcpy(row + (x * 2u), &value, 2u);
+			}
+			break;
+		case Dither::Ordered:
+			for (std::size_t x{ 0u }; x < rect.size.x; ++x)
+			{
+				// each value is offset by a threshold in [0, 1) of a quantisation step before truncating
+				const int threshold{ (thresholds[((y & 3u) * 4u) + (x & 3u)] * 2) + 1 };
+				std::uint16_t value{ 0u };
+				for (std::size_t c{ 0u }; c < 3u; ++c)
+					value |= static_cast<std::uint16_t>(((source[(x * 4u) + offsets[c]] * maxValues[c] * 32) + (threshold * 255)) / (255 * 32)) << shifts[c];
+				value |= static_cast<std::uint16_t>(((source[(x * 4u) + 3u] * maxValues[3u]) + 127) / 255) << shifts[3u];
+				std::memcpy(row + (x * 2u), &value, 2u);
+			}
+			break;
+		case Dither::ErrorDiffusion:
+			for (std::size_t x{ 0u }; x < rect.size.x; ++x)
+			{
+				std::uint16_t value{ 0u };
+				for (std::size_t c{ 0u }; c < 3u; ++c)
+				{
+					const std::size_t errorIndex{ ((x + 1u) * 3u) + c };
+					const int wanted{ std::clamp(source[(x * 4u) + offsets[c]] + (errors[errorIndex] / 16), 0, 255) };
+					const int quantised{ ((wanted * maxValues[c]) + 127) / 255 };
+					const int error{ wanted - (((quantised * 255) + (maxValues[c] / 2)) / maxValues[c]) };
+					errors[errorIndex + 3u] += error * 7;
+					nextErrors[errorIndex - 3u] += error * 3;
+					nextErrors[errorIndex] += error * 5;
+					nextErrors[errorIndex + 3u] += error;
+					value |= static_cast<std::uint16_t>(quantised) << shifts[c];
+				}
+				value |= static_cast<std::uint16_t>(((source[(x * 4u) + 3u] * maxValues[3u]) + 127) / 255) << shifts[3u];
+				std::memcpy(row + (x * 2u), &value, 2u);
+			}
+			errors.swap(nextErrors);
+			std::fill(nextErrors.begin(), nextErrors.end(), 0);
+			break;
+		}
+	}
+}
+
+} // namespace sheetimageprocessor
@@ -0,0 +1,124 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Sheet Image Processor (https://github.com/Hapaxia/SheetImageProcessor
+// --
+//
+// Parallel
+//
+// Copyright(c) 2025-2026 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions :
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software.If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Common.hpp"
+
+#include <algorithm>
+#include <functional>
+
+#ifndef SHEETIMAGEPROCESSOR_NO_THREADS
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#endif // SHEETIMAGEPROCESSOR_NO_THREADS
+
+namespace sheetimageprocessor
+{
+
+// runs independent jobs (tiles, rows, blocks) across threads.
+// define SHEETIMAGEPROCESSOR_NO_THREADS to always run jobs on the calling thread
+class Parallel
+{
+public:
+	static void setMaxNumberOfThreads(std::size_t maxNumberOfThreads); // 0 uses the hardware's concurrency. 1 runs everything on the calling thread
+	static std::size_t getMaxNumberOfThreads();
+
+	static void forEach(std::size_t numberOfJobs, const std::function<void(std::size_t)>& jobFunction); // calls jobFunction once for each job index. jobs must not write to the same pixels
+
+private:
+	static inline std::size_t m_maxNumberOfThreads{ 0u };
+};
+
+inline void Parallel::setMaxNumberOfThreads(const std::size_t maxNumberOfThreads)
+{
+	m_maxNumberOfThreads = maxNumberOfThreads;
+}
+
+inline std::size_t Parallel::getMaxNumberOfThreads()
+{
+#ifdef SHEETIMAGEPROCESSOR_NO_THREADS
+	return 1u;
+#else
+	if (m_maxNumberOfThreads != 0u)
+		return m_maxNumberOfThreads;
+	const std::size_t hardwareConcurrency{ std::thread::hardware_concurrency() };
+	return (hardwareConcurrency == 0u) ? 1u : hardwareConcurrency;
+#endif // SHEETIMAGEPROCESSOR_NO_THREADS
+}
+
+inline void Parallel::forEach(const std::size_t numberOfJobs, const std::function<void(std::size_t)>& jobFunction)
+{
+	const std::size_t numberOfThreads{ std::min(getMaxNumberOfThreads(), numberOfJobs) };
+	if (numberOfThreads <= 1u)
+	{
+		for (std::size_t i{ 0u }; i < numberOfJobs; ++i)
+			jobFunction(i);
+		return;
+	}
+
+#ifndef SHEETIMAGEPROCESSOR_NO_THREADS
+	std::atomic<std::size_t> nextJob{ 0u };
+	std::exception_ptr exception{};
+	std::mutex exceptionMutex{};
+	auto worker = [&]()
+	{
+		try
+		{
+			for (std::size_t i{ nextJob++ }; i < numberOfJobs; i = nextJob++)
+				jobFunction(i);
+		}
+		catch (...)
+		{
+			const std::lock_guard<std::mutex> lock{ exceptionMutex };
+			if (!exception)
+				exception = std::current_exception();
+			nextJob = numberOfJobs; // stop handing out jobs
+		}
+	};
+
+	std::vector<std::thread> threads{};
+	threads.reserve(numberOfThreads - 1u);
+	for (std::size_t i{ 1u }; i < numberOfThreads; ++i)
+		threads.emplace_back(worker);
+	worker();
+	for (auto& thread : threads)
+		thread.join();
+
+	if (exception)
+		std::rethrow_exception(exception);
+#endif // SHEETIMAGEPROCESSOR_NO_THREADS
+}
+
+} // namespace sheetimageprocessor
@@ -59,10 +59,77 @@ struct Pixel
 		a = newA;
 	}
 
-	bool operator==(const Pixel& other) const
+	// packed into a 32-bit word: r in the lowest byte, a in the highest (whatever the platform's byte order)
+	static constexpr std::uint32_t maskR{ 0x000000FFu };
+	static constexpr std::uint32_t maskG{ 0x0000FF00u };
+	static constexpr std::uint32_t maskB{ 0x00FF0000u };
+	static constexpr std::uint32_t maskA{ 0xFF000000u };
+	static constexpr std::uint32_t maskRgb{ maskR | maskG | maskB };
+
+	constexpr std::uint32_t getPacked() const
+	{
+		return static_cast<std::uint32_t>(r) | (static_cast<std::uint32_t>(g) << 8u) | (static_cast<std::uint32_t>(b) << 16u) | (static_cast<std::uint32_t>(a) << 24u);
+	}
+	static constexpr Pixel fromPacked(const std::uint32_t packed)
+	{
+		return { static_cast<std::uint8_t>(packed), static_cast<std::uint8_t>(packed >> 8u), static_cast<std::uint8_t>(packed >> 16u), static_cast<std::uint8_t>(packed >> 24u) };
+	}
+
+	// to and from the four bytes of a 32-bit pixel in Image (RGBA or BGRA order)
+	void pack(std::uint8_t* data, const bool isBgra = false) const
+	{
+		data[0u] = isBgra ? b : r;
+		data[1u] = g;
+		data[2u] = isBgra ? r : b;
+		data[3u] = a;
+	}
+	static Pixel unpack(const std::uint8_t* data, const bool isBgra = false)
+	{
+		return { isBgra ? data[2u] : data[0u], data[1u], isBgra ? data[0u] : data[2u], data[3u] };
+	}
+
+	constexpr bool operator==(const Pixel& other) const
+	{
+		return (getPacked() == other.getPacked());
+	}
+	constexpr bool isEqual(const Pixel& other, const std::uint32_t channelMask) const // compares only the channels in channelMask (e.g. maskRgb)
 	{
-		return ((r == other.r) && (g == other.g) && (b == other.b) && (a == other.a));
+		return (((getPacked() ^ other.getPacked()) & channelMask) == 0u);
+	}
+
+	// SWAR (SIMD within a register): each channel is widened to a 16-bit lane of a 64-bit word so lanes can borrow without affecting each other
+	static constexpr std::uint32_t getDifference(const std::uint32_t lhs, const std::uint32_t rhs) // the absolute difference of each channel
+	{
+		const std::uint64_t lanes{ (priv_spread(lhs) | 0x0100010001000100u) - priv_spread(rhs) };
+		const std::uint64_t isNegative{ (~lanes >> 8u) & 0x0001000100010001u };
+		const std::uint64_t negationMask{ isNegative * 0xFFu };
+		return priv_gather(((lanes & 0x00FF00FF00FF00FFu) ^ negationMask) + isNegative);
+	}
+	static constexpr bool isWithin(const std::uint32_t difference, const std::uint32_t tolerance) // whether every channel of difference is no more than the same channel of tolerance
+	{
+		const std::uint64_t lanes{ (priv_spread(tolerance) | 0x0100010001000100u) - priv_spread(difference) };
+		return (((lanes >> 8u) & 0x0001000100010001u) == 0x0001000100010001u);
+	}
+	static constexpr std::uint32_t getSum(const std::uint32_t packed) // the sum of all four channels
+	{
+		return static_cast<std::uint32_t>(((priv_spread(packed) * 0x0001000100010001u) >> 48u) & 0xFFFFu);
+	}
+
+private:
+	static constexpr std::uint64_t priv_spread(const std::uint32_t packed)
+	{
+		std::uint64_t lanes{ packed };
+		lanes = (lanes | (lanes << 16u)) & 0x0000FFFF0000FFFFu;
+		return (lanes | (lanes << 8u)) & 0x00FF00FF00FF00FFu;
+	}
+	static constexpr std::uint32_t priv_gather(std::uint64_t lanes)
+	{
+		lanes &= 0x00FF00FF00FF00FFu;
+		lanes = (lanes | (lanes >> 8u)) & 0x0000FFFF0000FFFFu;
+		return static_cast<std::uint32_t>(lanes | (lanes >> 16u));
 	}
 };
 
+static_assert(sizeof(Pixel) == 4u, "Pixel must be four packed bytes");
+
 } // namespace sheetimageprocessor
@@ -0,0 +1,74 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Sheet Image Processor (https://github.com/Hapaxia/SheetImageProcessor
+// --
+//
+// Quantiser
+//
+// Copyright(c) 2025-2026 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions :
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software.If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Common.hpp"
+#include "Image.hpp"
+#include "Atlas.hpp"
+
+#include <unordered_map>
+
+namespace sheetimageprocessor
+{
+
+// builds palettes (median cut with optional k-means refinement) and remaps images to them.
+// fully transparent pixels are all treated as transparent black
+class Quantiser
+{
+public:
+	static std::vector<Pixel> generatePalette(const Image& image, std::size_t maxNumberOfColours = 256u, std::size_t numberOfRefinements = 0u); // numberOfRefinements is the number of k-means iterations
+	static std::vector<Pixel> generatePalette(const Image& image, const Atlas& atlas, std::size_t maxNumberOfColours = 256u, std::size_t numberOfRefinements = 0u); // only the pixels within the atlas' tiles are counted
+	static void remap(const Image& sourceImage, Image& indexedImage, const std::vector<Pixel>& palette); // indexedImage becomes an Indexed8 image of sourceImage using palette (up to 256 colours)
+	static void remap(Image& image, const std::vector<Pixel>& palette); // converts image to Indexed8
+
+private:
+	class Lookup;
+
+	struct Entry
+	{
+		Pixel colour;
+		std::size_t count;
+	};
+
+	static constexpr std::size_t m_numberOfRowsPerJob{ 32u };
+
+	static std::vector<Entry> priv_countColours(const Image& image, const std::vector<Rect>& rects);
+	static std::vector<Pixel> priv_generatePalette(std::vector<Entry>& entries, std::size_t maxNumberOfColours, std::size_t numberOfRefinements);
+	static std::uint32_t priv_getKey(Pixel pixel);
+	static std::uint32_t priv_getKey(const std::uint8_t* rgba);
+	static const std::uint8_t* priv_getRgbaRow(const Image& image, Rect rect, Image& rowImage); // rect is a single row. other formats are converted into rowImage
+	static Pixel priv_getColour(std::uint32_t key);
+};
+
+} // namespace sheetimageprocessor
+#include "Quantiser.inl"
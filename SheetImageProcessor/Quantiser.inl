@@ -0,0 +1,370 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Sheet Image Processor (https://github.com/Hapaxia/SheetImageProcessor
+// --
+//
+// Quantiser
+//
+// Copyright(c) 2025-2026 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions :
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software.If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "Quantiser.hpp"
+
+#include <mutex>
+
+namespace sheetimageprocessor
+{
+
+// finds the nearest palette colour. the palette is sorted by green so the search can stop once green alone is further away than the best match
+class Quantiser::Lookup
+{
+public:
+	Lookup(const std::vector<Pixel>& palette)
+		: m_order(palette.size())
+		, m_palette{ palette }
+	{
+		for (std::size_t i{ 0u }; i < m_order.size(); ++i)
+			m_order[i] = i;
+		std::sort(m_order.begin(), m_order.end(), [&](const std::size_t a, const std::size_t b) { return (m_palette[a].g < m_palette[b].g); });
+	}
+
+	std::size_t find(const Pixel pixel) const
+	{
+		const std::size_t paletteSize{ m_order.size() };
+		if (paletteSize == 0u)
+			return 0u;
+		const std::size_t start{ static_cast<std::size_t>(std::lower_bound(m_order.begin(), m_order.end(), pixel.g, [&](const std::size_t i, const std::uint8_t g) { return (m_palette[i].g < g); }) - m_order.begin()) };
+		std::size_t nearestIndex{ m_order[std::min(start, paletteSize - 1u)] };
+		int nearestDistance{ priv_getDistance(pixel, m_palette[nearestIndex]) };
+		bool isSearchingUp{ true };
+		bool isSearchingDown{ true };
+		for (std::size_t step{ 0u }; isSearchingUp || isSearchingDown; ++step)
+		{
+			if (isSearchingUp)
+			{
+				const std::size_t i{ start + step };
+				isSearchingUp = (i < paletteSize) && (priv_getGreenDistance(pixel, m_palette[m_order[i]]) < nearestDistance);
+				if (isSearchingUp)
+					priv_consider(pixel, m_order[i], nearestIndex, nearestDistance);
+			}
+			if (isSearchingDown)
+			{
+				isSearchingDown = (step < start) && (priv_getGreenDistance(pixel, m_palette[m_order[start - step - 1u]]) < nearestDistance);
+				if (isSearchingDown)
+					priv_consider(pixel, m_order[start - step - 1u], nearestIndex, nearestDistance);
+			}
+		}
+		return nearestIndex;
+	}
+
+private:
+	std::vector<std::size_t> m_order;
+	const std::vector<Pixel>& m_palette;
+
+	void priv_consider(const Pixel pixel, const std::size_t index, std::size_t& nearestIndex, int& nearestDistance) const
+	{
+		const int distance{ priv_getDistance(pixel, m_palette[index]) };
+		if (distance < nearestDistance)
+		{
+			nearestIndex = index;
+			nearestDistance = distance;
+		}
+	}
+	static int priv_getGreenDistance(const Pixel a, const Pixel b)
+	{
+		const int differenceG{ static_cast<int>(a.g) - static_cast<int>(b.g) };
+		return (differenceG * differenceG);
+	}
+	static int priv_getDistance(const Pixel a, const Pixel b)
+	{
+		const int differenceR{ static_cast<int>(a.r) - static_cast<int>(b.r) };
+		const int differenceB{ static_cast<int>(a.b) - static_cast<int>(b.b) };
+		const int differenceA{ static_cast<int>(a.a) - static_cast<int>(b.a) };
+		return (differenceR * differenceR) + priv_getGreenDistance(a, b) + (differenceB * differenceB) + (differenceA * differenceA);
+	}
+};
+
+inline std::vector<Pixel> Quantiser::generatePalette(const Image& image, const std::size_t maxNumberOfColours, const std::size_t numberOfRefinements)
+{
+	std::vector<Entry> entries{ priv_countColours(image, { { { 0u, 0u }, image.getSize() } }) };
+	return priv_generatePalette(entries, maxNumberOfColours, numberOfRefinements);
+}
+
+inline std::vector<Pixel> Quantiser::generatePalette(const Image& image, const Atlas& atlas, const std::size_t maxNumberOfColours, const std::size_t numberOfRefinements)
+{
+	const Xy size{ image.getSize() };
+	std::vector<Rect> rects{};
+	for (const Atlas::Tile& tile : atlas.constAccess())
+	{
+		Rect rect{ tile.rect };
+		if ((rect.position.x >= size.x) || (rect.position.y >= size.y))
+			continue;
+		rect.size.x = std::min(rect.size.x, size.x - rect.position.x);
+		rect.size.y = std::min(rect.size.y, size.y - rect.position.y);
+		rects.push_back(rect);
+	}
+	std::vector<Entry> entries{ priv_countColours(image, rects) };
+	return priv_generatePalette(entries, maxNumberOfColours, numberOfRefinements);
+}
+
+inline void Quantiser::remap(const Image& sourceImage, Image& indexedImage, const std::vector<Pixel>& palette)
+{
+	if (&sourceImage == &indexedImage)
+	{
+		remap(indexedImage, palette);
+		return;
+	}
+
+	const Xy size{ sourceImage.getSize() };
+	indexedImage.setPalette(palette);
+	indexedImage.setPixelFormat(Image::PixelFormat::Indexed8, false);
+	indexedImage.setIsTopDown(sourceImage.getIsTopDown(), false);
+	indexedImage.setSize(size, false);
+	if ((size.x == 0u) || (size.y == 0u))
+		return;
+
+	// each distinct colour is looked up once, after which remapping a pixel is a hash lookup
+	std::vector<Entry> entries{ priv_countColours(sourceImage, { { { 0u, 0u }, size } }) };
+	const Lookup lookup{ palette };
+	std::unordered_map<std::uint32_t, std::uint8_t> indices{};
+	indices.reserve(entries.size());
+	for (const Entry& entry : entries)
+		indices.emplace(priv_getKey(entry.colour), static_cast<std::uint8_t>(lookup.find(entry.colour)));
+
+	indexedImage.takeOwnership();
+	Parallel::forEach((size.y + m_numberOfRowsPerJob - 1u) / m_numberOfRowsPerJob, [&](const std::size_t jobIndex)
+	{
+		const std::size_t firstRow{ jobIndex * m_numberOfRowsPerJob };
+		const std::size_t endRow{ std::min(firstRow + m_numberOfRowsPerJob, size.y) };
+		Image rowImage{};
+		for (std::size_t y{ firstRow }; y < endRow; ++y)
+		{
+			const std::uint8_t* sourceRow{ priv_getRgbaRow(sourceImage, { { 0u, y }, { size.x, 1u } }, rowImage) };
+			std::uint8_t* row{ indexedImage.accessRowData(y) };
+			std::uint32_t previousKey{ priv_getKey(sourceRow) };
+			std::uint8_t previousIndex{ indices.at(previousKey) };
+			for (std::size_t x{ 0u }; x < size.x; ++x)
+			{
+				const std::uint32_t key{ priv_getKey(sourceRow + (x * 4u)) };
+				if (key != previousKey)
+				{
+					previousKey = key;
+					previousIndex = indices.at(key);
+				}
+				row[x] = previousIndex;
+			}
+		}
+	});
+}
+
+inline void Quantiser::remap(Image& image, const std::vector<Pixel>& palette)
+{
+	Image indexedImage{};
+	indexedImage.setScratchPool(image.getScratchPool());
+	remap(static_cast<const Image&>(image), indexedImage, palette);
+	image.setPalette(palette);
+	image.setPixelFormat(Image::PixelFormat::Indexed8, false);
+	image.setSize(indexedImage.getSize(), false);
+	image.copy({ 0u, 0u }, indexedImage, { { 0u, 0u }, indexedImage.getSize() });
+}
+
+inline std::vector<Quantiser::Entry> Quantiser::priv_countColours(const Image& image, const std::vector<Rect>& rects)
+{
+	// bands of rows of each rect are counted in parallel into their own tables, which are then merged
+	std::vector<std::pair<std::size_t, std::size_t>> jobs{}; // rect index, first row
+	for (std::size_t i{ 0u }; i < rects.size(); ++i)
+	{
+		for (std::size_t y{ 0u }; y < rects[i].size.y; y += m_numberOfRowsPerJob)
+			jobs.push_back({ i, y });
+	}
+	std::unordered_map<std::uint32_t, std::size_t> counts{};
+	std::mutex countsMutex{};
+	Parallel::forEach(jobs.size(), [&](const std::size_t jobIndex)
+	{
+		const Rect& rect{ rects[jobs[jobIndex].first] };
+		const std::size_t firstRow{ jobs[jobIndex].second };
+		const std::size_t endRow{ std::min(firstRow + m_numberOfRowsPerJob, rect.size.y) };
+		std::unordered_map<std::uint32_t, std::size_t> partialCounts{};
+		Image rowImage{};
+		for (std::size_t y{ firstRow }; y < endRow; ++y)
+		{
+			const std::uint8_t* row{ priv_getRgbaRow(image, { rect.position + Xy{ 0u, y }, { rect.size.x, 1u } }, rowImage) };
+			for (std::size_t x{ 0u }; x < rect.size.x; ++x)
+				++partialCounts[priv_getKey(row + (x * 4u))];
+		}
+		const std::lock_guard<std::mutex> lock{ countsMutex };
+		for (const auto& partialCount : partialCounts)
+			counts[partialCount.first] += partialCount.second;
+	});
+
+	std::vector<Entry> entries{};
+	entries.reserve(counts.size());
+	for (const auto& count : counts)
+		entries.push_back({ priv_getColour(count.first), count.second });
+	return entries;
+}
+
+inline std::vector<Pixel> Quantiser::priv_generatePalette(std::vector<Entry>& entries, std::size_t maxNumberOfColours, const std::size_t numberOfRefinements)
+{
+	maxNumberOfColours = std::min(maxNumberOfColours, std::size_t{ 256u });
+	if (entries.empty() || (maxNumberOfColours == 0u))
+		return {};
+
+	auto getChannel = [](const Pixel& pixel, const std::size_t channel)
+	{
+		switch (channel)
+		{
+		case 0u:
+			return pixel.r;
+		case 1u:
+			return pixel.g;
+		case 2u:
+			return pixel.b;
+		default:
+			return pixel.a;
+		}
+	};
+
+	// median cut: the box with the widest channel is split at the (count-weighted) median of that channel
+	struct Box
+	{
+		std::size_t begin;
+		std::size_t end;
+		std::size_t channel;
+		int range;
+	};
+	auto makeBox = [&](const std::size_t begin, const std::size_t end)
+	{
+		Box box{ begin, end, 0u, 0 };
+		for (std::size_t channel{ 0u }; channel < 4u; ++channel)
+		{
+			int minimum{ 255 };
+			int maximum{ 0 };
+			for (std::size_t i{ begin }; i < end; ++i)
+			{
+				minimum = std::min(minimum, static_cast<int>(getChannel(entries[i].colour, channel)));
+				maximum = std::max(maximum, static_cast<int>(getChannel(entries[i].colour, channel)));
+			}
+			if ((maximum - minimum) > box.range)
+			{
+				box.range = maximum - minimum;
+				box.channel = channel;
+			}
+		}
+		return box;
+	};
+	std::vector<Box> boxes{ makeBox(0u, entries.size()) };
+	while (boxes.size() < maxNumberOfColours)
+	{
+		const auto widest{ std::max_element(boxes.begin(), boxes.end(), [](const Box& a, const Box& b) { return (a.range < b.range); }) };
+		if (widest->range == 0)
+			break;
+		const Box box{ *widest };
+		std::sort(entries.begin() + box.begin, entries.begin() + box.end, [&](const Entry& a, const Entry& b) { return (getChannel(a.colour, box.channel) < getChannel(b.colour, box.channel)); });
+		std::size_t total{ 0u };
+		for (std::size_t i{ box.begin }; i < box.end; ++i)
+			total += entries[i].count;
+		std::size_t middle{ box.begin + 1u };
+		for (std::size_t cumulative{ entries[box.begin].count }; ((cumulative * 2u) < total) && (middle < (box.end - 1u)); ++middle)
+			cumulative += entries[middle].count;
+		*widest = makeBox(box.begin, middle);
+		boxes.push_back(makeBox(middle, box.end));
+	}
+
+	// each palette colour is the (count-weighted) mean of its box
+	std::vector<Pixel> palette(boxes.size());
+	std::vector<std::size_t> assignments(entries.size());
+	for (std::size_t b{ 0u }; b < boxes.size(); ++b)
+	{
+		for (std::size_t i{ boxes[b].begin }; i < boxes[b].end; ++i)
+			assignments[i] = b;
+	}
+	auto setMeans = [&]()
+	{
+		std::vector<std::array<std::size_t, 5u>> sums(palette.size()); // r, g, b, a, count
+		for (std::size_t i{ 0u }; i < entries.size(); ++i)
+		{
+			std::array<std::size_t, 5u>& sum{ sums[assignments[i]] };
+			for (std::size_t channel{ 0u }; channel < 4u; ++channel)
+				sum[channel] += getChannel(entries[i].colour, channel) * entries[i].count;
+			sum[4u] += entries[i].count;
+		}
+		for (std::size_t p{ 0u }; p < palette.size(); ++p)
+		{
+			const std::array<std::size_t, 5u>& sum{ sums[p] };
+			if (sum[4u] == 0u)
+				continue; // an emptied cluster keeps its colour
+			const std::size_t half{ sum[4u] / 2u };
+			palette[p] = { static_cast<std::uint8_t>((sum[0u] + half) / sum[4u]), static_cast<std::uint8_t>((sum[1u] + half) / sum[4u]), static_cast<std::uint8_t>((sum[2u] + half) / sum[4u]), static_cast<std::uint8_t>((sum[3u] + half) / sum[4u]) };
+		}
+	};
+	setMeans();
+
+	// k-means: each colour moves to its nearest palette colour, which moves to the mean of its colours
+	for (std::size_t refinement{ 0u }; refinement < numberOfRefinements; ++refinement)
+	{
+		const Lookup lookup{ palette };
+		bool hasChanged{ false };
+		for (std::size_t i{ 0u }; i < entries.size(); ++i)
+		{
+			const std::size_t nearest{ lookup.find(entries[i].colour) };
+			hasChanged = hasChanged || (nearest != assignments[i]);
+			assignments[i] = nearest;
+		}
+		if (!hasChanged)
+			break;
+		setMeans();
+	}
+	return palette;
+}
+
+inline std::uint32_t Quantiser::priv_getKey(const Pixel pixel)
+{
+	if (pixel.a == 0u)
+		return 0u;
+	return (static_cast<std::uint32_t>(pixel.r) << 24u) | (static_cast<std::uint32_t>(pixel.g) << 16u) | (static_cast<std::uint32_t>(pixel.b) << 8u) | pixel.a;
+}
+
+inline std::uint32_t Quantiser::priv_getKey(const std::uint8_t* rgba)
+{
+	return priv_getKey(Pixel{ rgba[0u], rgba[1u], rgba[2u], rgba[3u] });
+}
+
+inline const std::uint8_t* Quantiser::priv_getRgbaRow(const Image& image, const Rect rect, Image& rowImage)
+{
+	if (image.getPixelFormat() == Image::PixelFormat::RGBA)
+		return image.getRowData(rect.position.y) + (rect.position.x * 4u);
+	rowImage.setSize(rect.size, false);
+	rowImage.copy({ 0u, 0u }, image, rect);
+	return rowImage.getRowData(0u);
+}
+
+inline Pixel Quantiser::priv_getColour(const std::uint32_t key)
+{
+	return { static_cast<std::uint8_t>(key >> 24u), static_cast<std::uint8_t>(key >> 16u), static_cast<std::uint8_t>(key >> 8u), static_cast<std::uint8_t>(key) };
+}
+
+} // namespace sheetimageprocessor
@@ -34,53 +34,115 @@
 
 #include "Common.hpp"
 #include "Xy.hpp"
+#include <limits>
+#include <algorithm>
 
 namespace sheetimageprocessor
 {
 
-class Rect
+template <class T>
+class BasicRect
 {
 public:
-	Xy position;
-	Xy size;
+	using Coordinate = T;
 
-	constexpr Rect()
+	BasicXy<T> position;
+	BasicXy<T> size;
+
+	constexpr BasicRect()
 		: position{}
 		, size{}
 	{
 	}
 
-	constexpr Rect(const Xy& newPosition, const Xy& newSize)
+	constexpr BasicRect(const BasicXy<T>& newPosition, const BasicXy<T>& newSize)
+		: position{ newPosition }
+		, size{ newSize }
 	{
-		position = newPosition;
-		size = newSize;
 	}
 
-	template <class T>
-	constexpr Rect(const T& otherPositionAndSize)
+	template <class U>
+		requires requires (const U& otherPositionAndSize) { otherPositionAndSize.position; otherPositionAndSize.size; }
+	constexpr explicit(BasicXy<T>::template isNarrowing<std::remove_cvref_t<decltype(std::declval<const U&>().position)>>() ||
+		BasicXy<T>::template isNarrowing<std::remove_cvref_t<decltype(std::declval<const U&>().size)>>())
+		BasicRect(const U& otherPositionAndSize) // conversion from any type with position and size. explicit (and unchecked) if it could lose coordinates: use narrow to convert to a smaller coordinate type safely
+		: position{ static_cast<BasicXy<T>>(otherPositionAndSize.position) }
+		, size{ static_cast<BasicXy<T>>(otherPositionAndSize.size) }
+	{
+	}
+
+	template <class U>
+	static constexpr bool canNarrow(const U& otherPositionAndSize) // true if position, size and far edges can all be represented by T
+	{
+		if (!BasicXy<T>::canNarrow(otherPositionAndSize.position) || !BasicXy<T>::canNarrow(otherPositionAndSize.size))
+			return false;
+		return ((static_cast<std::uint64_t>(otherPositionAndSize.position.x) + otherPositionAndSize.size.x) <= std::numeric_limits<T>::max()) &&
+			((static_cast<std::uint64_t>(otherPositionAndSize.position.y) + otherPositionAndSize.size.y) <= std::numeric_limits<T>::max());
+	}
+	template <class U>
+	static constexpr BasicRect narrow(const U& otherPositionAndSize) // checked conversion. throws if position, size or far edges cannot be represented by T
 	{
-		position = static_cast<Xy>(otherPositionAndSize.position);
-		size = static_cast<Xy>(otherPositionAndSize.size);
+		if (!canNarrow(otherPositionAndSize))
+			throw Exception("Cannot narrow Rect: coordinate out of range.");
+		return BasicRect(otherPositionAndSize);
 	}
 
-	constexpr bool contains(const Xy point) const
+	constexpr bool contains(const BasicXy<T> point) const
 	{
 		return ((point.x >= position.x) && (point.x < (position.x + size.x)) && (point.y >= position.y) && (point.y < (position.y + size.y)));
 	}
+	constexpr bool contains(const BasicRect other) const // true if all of other is within this rect. an empty other is contained if its position is within (or on the far edges of) this rect
+	{
+		return ((other.position.x >= position.x) && ((other.position.x + other.size.x) <= (position.x + size.x)) &&
+			(other.position.y >= position.y) && ((other.position.y + other.size.y) <= (position.y + size.y)));
+	}
+	constexpr bool intersects(const BasicRect other) const // true if the rects share at least one pixel
+	{
+		return ((position.x < (other.position.x + other.size.x)) && (other.position.x < (position.x + size.x)) &&
+			(position.y < (other.position.y + other.size.y)) && (other.position.y < (position.y + size.y)));
+	}
+	constexpr BasicRect getIntersection(const BasicRect other) const // the pixels in both rects. has no size if they do not intersect
+	{
+		const T left{ std::max(position.x, other.position.x) };
+		const T top{ std::max(position.y, other.position.y) };
+		const T right{ std::min(static_cast<T>(position.x + size.x), static_cast<T>(other.position.x + other.size.x)) };
+		const T bottom{ std::min(static_cast<T>(position.y + size.y), static_cast<T>(other.position.y + other.size.y)) };
+		return{ { left, top }, { (right > left) ? static_cast<T>(right - left) : T{ 0u }, (bottom > top) ? static_cast<T>(bottom - top) : T{ 0u } } };
+	}
+	constexpr BasicRect getUnion(const BasicRect other) const // the smallest rect that contains both rects. a rect with no size is ignored
+	{
+		if (getIsEmpty())
+			return other;
+		if (other.getIsEmpty())
+			return *this;
+		const T left{ std::min(position.x, other.position.x) };
+		const T top{ std::min(position.y, other.position.y) };
+		const T right{ std::max(static_cast<T>(position.x + size.x), static_cast<T>(other.position.x + other.size.x)) };
+		const T bottom{ std::max(static_cast<T>(position.y + size.y), static_cast<T>(other.position.y + other.size.y)) };
+		return{ { left, top }, { static_cast<T>(right - left), static_cast<T>(bottom - top) } };
+	}
+	constexpr BasicRect getClamped(const BasicXy<T> bounds) const // the part of this rect within a rect of size bounds at (0, 0). e.g. an image's size
+	{
+		return getIntersection({ {}, bounds });
+	}
+	constexpr bool getIsEmpty() const
+	{
+		return ((size.x == 0u) || (size.y == 0u));
+	}
 	constexpr std::size_t getArea() const
 	{
-		return size.x * size.y;
+		return static_cast<std::size_t>(size.x) * size.y;
 	}
-	constexpr Xy getBottomRight() const
+	constexpr BasicXy<T> getBottomRight() const
 	{
-		return{ position.x + size.x - 1u, position.y + size.y - 1u };
+		return{ static_cast<T>(position.x + size.x - 1u), static_cast<T>(position.y + size.y - 1u) };
 	}
 
-	constexpr bool operator==(const Rect other)
+	constexpr bool operator==(const BasicRect other) const
 	{
 		return ((position == other.position) && (size == other.size));
 	}
-	constexpr bool operator!=(const Rect other)
+	constexpr bool operator!=(const BasicRect other) const
 	{
 		return !(*this == other);
 	}
@@ -91,4 +153,8 @@ public:
 	}
 };
 
+using Rect = BasicRect<std::size_t>;
+using Rect32 = BasicRect<std::uint32_t>; // 16 bytes instead of 32
+using Rect16 = BasicRect<std::uint16_t>; // 8 bytes
+
 } // namespace sheetimageprocessor
@@ -0,0 +1,149 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Sheet Image Processor (https://github.com/Hapaxia/SheetImageProcessor
+// --
+//
+// ScratchPool
+//
+// Copyright(c) 2025-2026 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions :
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software.If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Common.hpp"
+#include "Allocator.hpp"
+
+#include <algorithm>
+#include <mutex>
+
+namespace sheetimageprocessor
+{
+
+// keeps released buffers so that later temporaries (and later images) can reuse their memory instead of allocating again.
+// an image using a pool returns its data to the pool when destroyed, so the pool must outlive every image that uses it
+class ScratchPool
+{
+public:
+	ScratchPool(std::size_t maxNumberOfBuffers = 16u);
+
+	AlignedBuffer acquire(std::size_t size); // returns a buffer of size bytes. its contents are unspecified
+	void release(AlignedBuffer&& buffer);
+	void clear();
+
+	void setMaxNumberOfBuffers(std::size_t maxNumberOfBuffers);
+	std::size_t getMaxNumberOfBuffers() const;
+	std::size_t getNumberOfBuffers() const;
+
+private:
+	std::size_t m_maxNumberOfBuffers;
+	std::vector<AlignedBuffer> m_buffers;
+	mutable std::mutex m_mutex;
+};
+
+inline ScratchPool::ScratchPool(const std::size_t maxNumberOfBuffers)
+	: m_maxNumberOfBuffers{ maxNumberOfBuffers }
+	, m_buffers{}
+	, m_mutex{}
+{
+
+}
+
+inline AlignedBuffer ScratchPool::acquire(const std::size_t size)
+{
+	AlignedBuffer buffer{};
+	{
+		const std::lock_guard<std::mutex> lock{ m_mutex };
+
+		// use the smallest buffer that is big enough. if none are, grow the largest one
+		const std::size_t numberOfBuffers{ m_buffers.size() };
+		std::size_t bestIndex{ numberOfBuffers };
+		for (std::size_t i{ 0u }; i < numberOfBuffers; ++i)
+		{
+			const std::size_t capacity{ m_buffers[i].capacity() };
+			if (bestIndex == numberOfBuffers)
+				bestIndex = i;
+			else
+			{
+				const std::size_t bestCapacity{ m_buffers[bestIndex].capacity() };
+				const bool isBigEnough{ capacity >= size };
+				const bool isBestBigEnough{ bestCapacity >= size };
+				if ((isBigEnough && (!isBestBigEnough || (capacity < bestCapacity))) || (!isBigEnough && !isBestBigEnough && (capacity > bestCapacity)))
+					bestIndex = i;
+			}
+		}
+		if (bestIndex < numberOfBuffers)
+		{
+			buffer = std::move(m_buffers[bestIndex]);
+			m_buffers.erase(m_buffers.begin() + bestIndex);
+		}
+	}
+	buffer.resize(size);
+	return buffer;
+}
+
+inline void ScratchPool::release(AlignedBuffer&& buffer)
+{
+	if (buffer.capacity() == 0u)
+		return;
+
+	const std::lock_guard<std::mutex> lock{ m_mutex };
+	if (m_buffers.size() < m_maxNumberOfBuffers)
+	{
+		m_buffers.push_back(std::move(buffer));
+		return;
+	}
+
+	// when full, keep the larger buffers
+	auto smallest{ std::min_element(m_buffers.begin(), m_buffers.end(), [](const AlignedBuffer& lhs, const AlignedBuffer& rhs) { return (lhs.capacity() < rhs.capacity()); }) };
+	if ((smallest != m_buffers.end()) && (smallest->capacity() < buffer.capacity()))
+		*smallest = std::move(buffer);
+}
+
+inline void ScratchPool::clear()
+{
+	const std::lock_guard<std::mutex> lock{ m_mutex };
+	m_buffers.clear();
+}
+
+inline void ScratchPool::setMaxNumberOfBuffers(const std::size_t maxNumberOfBuffers)
+{
+	const std::lock_guard<std::mutex> lock{ m_mutex };
+	m_maxNumberOfBuffers = maxNumberOfBuffers;
+	if (m_buffers.size() > m_maxNumberOfBuffers)
+		m_buffers.resize(m_maxNumberOfBuffers);
+}
+
+inline std::size_t ScratchPool::getMaxNumberOfBuffers() const
+{
+	return m_maxNumberOfBuffers;
+}
+
+inline std::size_t ScratchPool::getNumberOfBuffers() const
+{
+	const std::lock_guard<std::mutex> lock{ m_mutex };
+	return m_buffers.size();
+}
+
+} // namespace sheetimageprocessor
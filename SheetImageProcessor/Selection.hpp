@@ -0,0 +1,87 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Sheet Image Processor (https://github.com/Hapaxia/SheetImageProcessor
+// --
+//
+// Selection
+//
+// Copyright(c) 2025-2026 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions :
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software.If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Common.hpp"
+#include "Xy.hpp"
+#include "Rect.hpp"
+
+namespace sheetimageprocessor
+{
+
+// one bit per pixel, packed into 64-bit words. each row starts on a new word; bits past the end of a row are always clear
+class Selection
+{
+public:
+	Selection();
+	Selection(Xy size, bool isSelected = false);
+
+	void setSize(Xy size, bool isSelected = false); // all pixels are (de)selected
+	Xy getSize() const;
+
+	void set(Xy location, bool isSelected = true); // no effect outside the selection's size
+	bool get(Xy location) const; // false outside the selection's size
+	void set(Rect rect, bool isSelected = true); // clipped to the selection's size
+	void clear(bool isSelected = false);
+	void invert();
+
+	std::size_t getCount() const; // number of selected pixels
+	bool getIsEmpty() const;
+	Rect getBounds() const; // the smallest rect containing every selected pixel. has no size if none are selected
+
+	Selection& operator&=(const Selection& other); // sizes must match
+	Selection& operator|=(const Selection& other);
+	Selection& operator^=(const Selection& other);
+	Selection operator&(const Selection& other) const;
+	Selection operator|(const Selection& other) const;
+	Selection operator^(const Selection& other) const;
+	Selection operator~() const;
+
+	template <class Function>
+	void forEachSelected(Function function) const; // calls function(Xy) for each selected pixel, row by row
+
+	std::size_t getNumberOfWordsPerRow() const;
+	const std::uint64_t* getRowWords(std::size_t y) const;
+	std::uint64_t* accessRowWords(std::size_t y); // bits past the end of the row must be left clear
+
+private:
+	Xy m_size;
+	std::size_t m_numberOfWordsPerRow;
+	std::vector<std::uint64_t> m_words;
+
+	void priv_clearPadding();
+	void priv_checkSize(const Selection& other) const;
+};
+
+} // namespace sheetimageprocessor
+#include "Selection.inl"
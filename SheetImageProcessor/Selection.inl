@@ -0,0 +1,270 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Sheet Image Processor (https://github.com/Hapaxia/SheetImageProcessor
+// --
+//
+// Selection
+//
+// Copyright(c) 2025-2026 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions :
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software.If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "Selection.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace sheetimageprocessor
+{
+
+inline Selection::Selection()
+	: m_size{}
+	, m_numberOfWordsPerRow{ 0u }
+	, m_words()
+{
+}
+
+inline Selection::Selection(const Xy size, const bool isSelected)
+	: Selection()
+{
+	setSize(size, isSelected);
+}
+
+inline void Selection::setSize(const Xy size, const bool isSelected)
+{
+	m_size = size;
+	m_numberOfWordsPerRow = (size.x + 63u) / 64u;
+	m_words.assign(m_numberOfWordsPerRow * size.y, 0u);
+	clear(isSelected);
+}
+
+inline Xy Selection::getSize() const
+{
+	return m_size;
+}
+
+inline void Selection::set(const Xy location, const bool isSelected)
+{
+	if ((location.x >= m_size.x) || (location.y >= m_size.y))
+		return;
+	const std::uint64_t bit{ std::uint64_t{ 1u } << (location.x % 64u) };
+	std::uint64_t& word{ m_words[(location.y * m_numberOfWordsPerRow) + (location.x / 64u)] };
+	if (isSelected)
+		word |= bit;
+	else
+		word &= ~bit;
+}
+
+inline bool Selection::get(const Xy location) const
+{
+	if ((location.x >= m_size.x) || (location.y >= m_size.y))
+		return false;
+	return ((m_words[(location.y * m_numberOfWordsPerRow) + (location.x / 64u)] >> (location.x % 64u)) & 1u) != 0u;
+}
+
+inline void Selection::set(Rect rect, const bool isSelected)
+{
+	if ((rect.position.x >= m_size.x) || (rect.position.y >= m_size.y))
+		return;
+	rect.size.x = std::min(rect.size.x, m_size.x - rect.position.x);
+	rect.size.y = std::min(rect.size.y, m_size.y - rect.position.y);
+	if ((rect.size.x == 0u) || (rect.size.y == 0u))
+		return;
+
+	// whole words where possible, with partial masks at each end
+	const std::size_t firstWord{ rect.position.x / 64u };
+	const std::size_t lastWord{ (rect.position.x + rect.size.x - 1u) / 64u };
+	const std::uint64_t firstMask{ ~std::uint64_t{ 0u } << (rect.position.x % 64u) };
+	const std::size_t endBit{ (rect.position.x + rect.size.x) % 64u };
+	const std::uint64_t lastMask{ (endBit == 0u) ? ~std::uint64_t{ 0u } : ((std::uint64_t{ 1u } << endBit) - 1u) };
+	for (std::size_t y{ rect.position.y }; y < (rect.position.y + rect.size.y); ++y)
+	{
+		std::uint64_t* row{ accessRowWords(y) };
+		for (std::size_t w{ firstWord }; w <= lastWord; ++w)
+		{
+			std::uint64_t mask{ ~std::uint64_t{ 0u } };
+			if (w == firstWord)
+				mask &= firstMask;
+			if (w == lastWord)
+				mask &= lastMask;
+			if (isSelected)
+				row[w] |= mask;
+			else
+				row[w] &= ~mask;
+		}
+	}
+}
+
+inline void Selection::clear(const bool isSelected)
+{
+	std::fill(m_words.begin(), m_words.end(), isSelected ? ~std::uint64_t{ 0u } : std::uint64_t{ 0u });
+	if (isSelected)
+		priv_clearPadding();
+}
+
+inline void Selection::invert()
+{
+	for (std::uint64_t& word : m_words)
+		word = ~word;
+	priv_clearPadding();
+}
+
+inline std::size_t Selection::getCount() const
+{
+	std::size_t count{ 0u };
+	for (const std::uint64_t word : m_words)
+		count += static_cast<std::size_t>(std::popcount(word));
+	return count;
+}
+
+inline bool Selection::getIsEmpty() const
+{
+	return std::all_of(m_words.begin(), m_words.end(), [](const std::uint64_t word) { return (word == 0u); });
+}
+
+inline Rect Selection::getBounds() const
+{
+	Xy minimum{ m_size };
+	Xy maximum{};
+	bool isAnySelected{ false };
+	for (std::size_t y{ 0u }; y < m_size.y; ++y)
+	{
+		const std::uint64_t* row{ getRowWords(y) };
+		for (std::size_t w{ 0u }; w < m_numberOfWordsPerRow; ++w)
+		{
+			if (row[w] == 0u)
+				continue;
+			const std::size_t first{ (w * 64u) + static_cast<std::size_t>(std::countr_zero(row[w])) };
+			const std::size_t last{ (w * 64u) + 63u - static_cast<std::size_t>(std::countl_zero(row[w])) };
+			minimum.x = std::min(minimum.x, first);
+			maximum.x = std::max(maximum.x, last);
+			minimum.y = std::min(minimum.y, y);
+			maximum.y = y;
+			isAnySelected = true;
+		}
+	}
+	if (!isAnySelected)
+		return {};
+	return { minimum, { maximum.x - minimum.x + 1u, maximum.y - minimum.y + 1u } };
+}
+
+inline Selection& Selection::operator&=(const Selection& other)
+{
+	priv_checkSize(other);
+	for (std::size_t i{ 0u }; i < m_words.size(); ++i)
+		m_words[i] &= other.m_words[i];
+	return *this;
+}
+
+inline Selection& Selection::operator|=(const Selection& other)
+{
+	priv_checkSize(other);
+	for (std::size_t i{ 0u }; i < m_words.size(); ++i)
+		m_words[i] |= other.m_words[i];
+	return *this;
+}
+
+inline Selection& Selection::operator^=(const Selection& other)
+{
+	priv_checkSize(other);
+	for (std::size_t i{ 0u }; i < m_words.size(); ++i)
+		m_words[i] ^= other.m_words[i];
+	return *this;
+}
+
+inline Selection Selection::operator&(const Selection& other) const
+{
+	Selection result{ *this };
+	result &= other;
+	return result;
+}
+
+inline Selection Selection::operator|(const Selection& other) const
+{
+	Selection result{ *this };
+	result |= other;
+	return result;
+}
+
+inline Selection Selection::operator^(const Selection& other) const
+{
+	Selection result{ *this };
+	result ^= other;
+	return result;
+}
+
+inline Selection Selection::operator~() const
+{
+	Selection result{ *this };
+	result.invert();
+	return result;
+}
+
+template <class Function>
+inline void Selection::forEachSelected(Function function) const
+{
+	for (std::size_t y{ 0u }; y < m_size.y; ++y)
+	{
+		const std::uint64_t* row{ getRowWords(y) };
+		for (std::size_t w{ 0u }; w < m_numberOfWordsPerRow; ++w)
+		{
+			for (std::uint64_t word{ row[w] }; word != 0u; word &= (word - 1u))
+				function(Xy{ (w * 64u) + static_cast<std::size_t>(std::countr_zero(word)), y });
+		}
+	}
+}
+
+inline std::size_t Selection::getNumberOfWordsPerRow() const
+{
+	return m_numberOfWordsPerRow;
+}
+
+inline const std::uint64_t* Selection::getRowWords(const std::size_t y) const
+{
+	return m_words.data() + (y * m_numberOfWordsPerRow);
+}
+
+inline std::uint64_t* Selection::accessRowWords(const std::size_t y)
+{
+	return m_words.data() + (y * m_numberOfWordsPerRow);
+}
+
+inline void Selection::priv_clearPadding()
+{
+	const std::size_t numberOfUsedBits{ m_size.x % 64u };
+	if (numberOfUsedBits == 0u)
+		return;
+	const std::uint64_t mask{ (std::uint64_t{ 1u } << numberOfUsedBits) - 1u };
+	for (std::size_t y{ 0u }; y < m_size.y; ++y)
+		accessRowWords(y)[m_numberOfWordsPerRow - 1u] &= mask;
+}
+
+inline void Selection::priv_checkSize(const Selection& other) const
+{
+	if ((m_size.x != other.m_size.x) || (m_size.y != other.m_size.y))
+		throw Exception("Cannot combine selections: sizes do not match.");
+}
+
+} // namespace sheetimageprocessor
@@ -33,82 +33,150 @@
 #pragma once
 
 #include "Common.hpp"
+#include <utility>
+#include <limits>
+#include <type_traits>
 
 namespace sheetimageprocessor
 {
 
-class Xy
+template <class T>
+class BasicXy
 {
 public:
-	std::size_t x;
-	std::size_t y;
+	using Coordinate = T;
 
-	constexpr Xy()
+	T x;
+	T y;
+
+	template <class U>
+	static constexpr bool isNarrowingCoordinate() // true if U is an integer type whose values can be larger than T can represent
+	{
+		if constexpr (std::is_integral_v<U>)
+			return (static_cast<std::uintmax_t>(std::numeric_limits<U>::max()) > static_cast<std::uintmax_t>(std::numeric_limits<T>::max()));
+		else
+			return false;
+	}
+	template <class U>
+	static constexpr bool isNarrowing() // true if an integer coordinate of U can be larger than T can represent
+	{
+		return (isNarrowingCoordinate<std::remove_cvref_t<decltype(std::declval<const U&>().x)>>() || isNarrowingCoordinate<std::remove_cvref_t<decltype(std::declval<const U&>().y)>>());
+	}
+
+	constexpr BasicXy()
 		: x{ 0u }
 		, y{ 0u }
 	{
 	}
 
-	constexpr Xy(const std::size_t newX, const std::size_t newY)
+	constexpr BasicXy(const T newX, const T newY)
+		: x{ newX }
+		, y{ newY }
 	{
-		x = newX;
-		y = newY;
 	}
 
-	template <class T>
-	constexpr Xy(const T& otherXy)
+	template <class U>
+		requires requires (const U& otherXy) { otherXy.x; otherXy.y; }
+	constexpr explicit(isNarrowing<U>()) BasicXy(const U& otherXy) // conversion from any type with x and y. explicit (and unchecked) if it could lose coordinates: use narrow to convert to a smaller coordinate type safely
+		: x{ static_cast<T>(otherXy.x) }
+		, y{ static_cast<T>(otherXy.y) }
 	{
-		x = static_cast<std::size_t>(otherXy.x);
-		y = static_cast<std::size_t>(otherXy.y);
 	}
-	template <class T, class U>
-	constexpr Xy(const T newX, const U newY)
+	template <class U, class V>
+		requires (!isNarrowingCoordinate<U>() && !isNarrowingCoordinate<V>())
+	constexpr BasicXy(const U newX, const V newY) // (coordinates that could lose values use the (T, T) constructor instead, so braced initialisation rejects them unless they are constants that fit. use narrow to convert them safely)
+		: x{ static_cast<T>(newX) }
+		, y{ static_cast<T>(newY) }
 	{
-		x = static_cast<std::size_t>(newX);
-		y = static_cast<std::size_t>(newY);
 	}
 
-	constexpr bool operator==(const Xy other)
+	template <class U>
+	static constexpr bool canNarrow(const U& otherXy) // true if both coordinates can be represented by T
+	{
+		return (std::in_range<T>(otherXy.x) && std::in_range<T>(otherXy.y));
+	}
+	template <class U>
+	static constexpr BasicXy narrow(const U& otherXy) // checked conversion. throws if either coordinate cannot be represented by T
+	{
+		if (!canNarrow(otherXy))
+			throw Exception("Cannot narrow Xy: coordinate out of range.");
+		return{ static_cast<T>(otherXy.x), static_cast<T>(otherXy.y) };
+	}
+	template <class U, class V>
+	static constexpr BasicXy narrow(const U newX, const V newY) // checked conversion. throws if either coordinate cannot be represented by T
+	{
+		if (!std::in_range<T>(newX) || !std::in_range<T>(newY))
+			throw Exception("Cannot narrow Xy: coordinate out of range.");
+		return{ static_cast<T>(newX), static_cast<T>(newY) };
+	}
+
+	constexpr bool operator==(const BasicXy other) const
 	{
 		return ((x == other.x) && (y == other.y));
 	}
-	constexpr Xy& operator+=(const Xy other)
+	constexpr BasicXy& operator+=(const BasicXy other)
 	{
 		x += other.x;
 		y += other.y;
 		return *this;
 	}
-	constexpr Xy& operator-=(const Xy other)
+	constexpr BasicXy& operator-=(const BasicXy other)
 	{
 		x -= other.x;
 		y -= other.y;
 		return *this;
 	}
-	constexpr Xy& operator*=(const Xy other)
+	constexpr BasicXy& operator*=(const BasicXy other)
 	{
 		x *= other.x;
 		y *= other.y;
 		return *this;
 	}
-	constexpr Xy& operator*=(const std::size_t scalar)
+	constexpr BasicXy& operator*=(const T scalar)
 	{
 		x *= scalar;
 		y *= scalar;
 		return *this;
 	}
-	constexpr Xy& operator/=(const Xy other)
+	constexpr BasicXy& operator/=(const BasicXy other)
 	{
 		x /= other.x;
 		y /= other.y;
 		return *this;
 	}
-	constexpr Xy& operator/=(const std::size_t scalar)
+	constexpr BasicXy& operator/=(const T scalar)
 	{
 		x /= scalar;
 		y /= scalar;
 		return *this;
 	}
 
+	// (defined as friends so that they are only found for this coordinate type; mixing coordinate types requires an explicit conversion)
+	friend constexpr BasicXy operator+(BasicXy lhs, const BasicXy rhs)
+	{
+		return lhs += rhs;
+	}
+	friend constexpr BasicXy operator-(BasicXy lhs, const BasicXy rhs)
+	{
+		return lhs -= rhs;
+	}
+	friend constexpr BasicXy operator*(BasicXy lhs, const BasicXy rhs)
+	{
+		return lhs *= rhs;
+	}
+	friend constexpr BasicXy operator*(BasicXy lhs, const T rhs)
+	{
+		return lhs *= rhs;
+	}
+	friend constexpr BasicXy operator/(BasicXy lhs, const BasicXy rhs)
+	{
+		return lhs /= rhs;
+	}
+	friend constexpr BasicXy operator/(BasicXy lhs, const T rhs)
+	{
+		return lhs /= rhs;
+	}
+
 	std::string asString(const bool isSize = false, const bool includeNewline = false) const
 	{
 		if (isSize)
@@ -118,29 +186,11 @@ public:
 	}
 };
 
-inline Xy operator+(Xy lhs, const Xy rhs)
-{
-	return lhs += rhs;
-}
-inline Xy operator-(Xy lhs, const Xy rhs)
-{
-	return lhs -= rhs;
-}
-inline Xy operator*(Xy lhs, const Xy rhs)
-{
-	return lhs *= rhs;
-}
-inline Xy operator*(Xy lhs, const std::size_t rhs)
-{
-	return lhs *= rhs;
-}
-inline Xy operator/(Xy lhs, const Xy rhs)
-{
-	return lhs /= rhs;
-}
-inline Xy operator/(Xy lhs, const std::size_t rhs)
-{
-	return lhs /= rhs;
-}
+using Xy = BasicXy<std::size_t>;
+using Xy32 = BasicXy<std::uint32_t>; // 8 bytes instead of 16. for large collections of coordinates such as fill queues
+using Xy16 = BasicXy<std::uint16_t>; // 4 bytes
+
+static_assert(sizeof(Xy32) == 8u);
+static_assert(sizeof(Xy16) == 4u);
 
 } // namespace sheetimageprocessor
@@ -35,3 +35,17 @@
 #include "Xy.hpp"
 #include "Rect.hpp"
 #include "Atlas.hpp"
+#include "Parallel.hpp"
+#include "Allocator.hpp"
+#include "ScratchPool.hpp"
+#include "ColourMap.hpp"
+#include "Selection.hpp"
+#include "Container.hpp"
+#include "Codec.hpp"
+#include "ChunkedImage.hpp"
+#include "Packed16.hpp"
+#include "Quantiser.hpp"
+#include "BlockCompressor.hpp"
+#include "Filter.hpp"
+#include "Morphology.hpp"
+#include "Census.hpp"
@@ -0,0 +1,43 @@
+// Regression test: copying within an image that views a loaded container file.
+// The copy-on-write of the destination must not release the mapped data that the source rows are read from.
+//
+// build and run (from the repository root), e.g.:
+// g++ -std=c++20 -I. tests/SelfCopyFromView.cpp -o SelfCopyFromView && ./SelfCopyFromView
+
+#include "SheetImageProcessor.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+
+int main()
+{
+	const std::string filename{ (std::filesystem::temp_directory_path() / "SelfCopyFromView.sipc").string() };
+
+	sip::Image original{};
+	original.setSize({ 16u, 16u });
+	original.processPixels([](sip::Pixel& pixel, const sip::Xy xy) { pixel = sip::Pixel{ static_cast<std::uint8_t>(xy.x), static_cast<std::uint8_t>(xy.y), 0u, 255u }; });
+	sip::Container::save(filename, original);
+
+	bool isPassed{ true };
+	{
+		sip::Image view{};
+		sip::Atlas atlas{};
+		sip::Container::load(filename, view, atlas);
+		view.copy(sip::Xy{ 0u, 0u }, view, sip::Rect{ sip::Xy{ 5u, 5u }, sip::Xy{ 4u, 4u } });
+		for (std::size_t y{ 0u }; y < 4u; ++y)
+		{
+			for (std::size_t x{ 0u }; x < 4u; ++x)
+			{
+				if (view.getPixel(sip::Xy{ x, y }) != original.getPixel(sip::Xy{ x + 5u, y + 5u }))
+					isPassed = false;
+			}
+		}
+		if (view.getPixel(sip::Xy{ 10u, 10u }) != original.getPixel(sip::Xy{ 10u, 10u }))
+			isPassed = false;
+	}
+	std::remove(filename.c_str());
+
+	std::cout << (isPassed ? "passed" : "FAILED") << std::endl;
+	return isPassed ? 0 : 1;
+}
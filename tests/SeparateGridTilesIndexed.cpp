@@ -0,0 +1,41 @@
+// Regression test: separating grid tiles in place on an Indexed8 image.
+// The tiles are read from a temporary copy of the grid, which must keep the image's palette.
+//
+// build and run (from the repository root), e.g.:
+// g++ -std=c++20 -I. tests/SeparateGridTilesIndexed.cpp -o SeparateGridTilesIndexed && ./SeparateGridTilesIndexed
+
+#include "SheetImageProcessor.hpp"
+
+#include <iostream>
+
+int main()
+{
+	const std::vector<sip::Pixel> palette{ { 0u, 0u, 0u, 0u }, { 255u, 0u, 0u, 255u }, { 0u, 255u, 0u, 255u }, { 0u, 0u, 255u, 255u }, { 255u, 255u, 255u, 255u } };
+	const std::vector<sip::Pixel> tileColours{ palette[1u], palette[2u], palette[3u], palette[4u] };
+
+	sip::Image image{};
+	image.setPalette(palette);
+	image.setPixelFormat(sip::Image::PixelFormat::Indexed8, false);
+	image.setSize({ 12u, 12u }, true, palette[0u]);
+	for (std::size_t i{ 0u }; i < 4u; ++i)
+		image.clear(sip::Rect{ sip::Xy{ (i % 2u) * 4u, (i / 2u) * 4u }, sip::Xy{ 4u, 4u } }, tileColours[i]);
+
+	image.separateGridTiles({ 0u, 0u }, { 0u, 0u }, { 2u, 2u }, { 4u, 4u }, { 2u, 2u }, 0u);
+
+	bool isPassed{ true };
+	for (std::size_t i{ 0u }; i < 4u; ++i)
+	{
+		const sip::Xy tilePosition{ (i % 2u) * 6u, (i / 2u) * 6u };
+		for (std::size_t y{ 0u }; y < 4u; ++y)
+		{
+			for (std::size_t x{ 0u }; x < 4u; ++x)
+			{
+				if (image.getPixel(sip::Xy{ tilePosition.x + x, tilePosition.y + y }) != tileColours[i])
+					isPassed = false;
+			}
+		}
+	}
+
+	std::cout << (isPassed ? "passed" : "FAILED") << std::endl;
+	return isPassed ? 0 : 1;
+}